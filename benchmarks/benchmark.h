@@ -0,0 +1,225 @@
+// Copyright (c) 2015, Lars Tingelstad
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of pyversor nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <functional>
+#include <regex>
+#include <string>
+#include <utility>
+#include <vector>
+
+// A minimal benchmark runner in the style of google-benchmark, without the
+// dependency. Each benchmark runs a loop of `n` operations; the runner grows
+// n until a run takes at least the minimum time and reports the time per
+// operation. Results are printed as a table and written as JSON in the layout
+// of google-benchmark's --benchmark_out, with `flops` per operation as a
+// counter, so its tools/compare.py can diff runs across releases and
+// compilers.
+//
+// Flags:
+//   --benchmark_filter=<regex>       run the benchmarks whose name matches
+//   --benchmark_min_time=<seconds>   minimum time of a run, 0.5 by default
+//   --benchmark_out=<file>           write the results as JSON
+namespace pyversor {
+
+namespace benchmark {
+
+// Keeps the compiler from optimizing away the computation of `value`.
+template <typename T> inline void do_not_optimize(const T &value) {
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+struct result {
+  std::string name;
+  std::size_t iterations;
+  double real_time;
+  double cpu_time;
+  double flops;
+};
+
+class runner {
+public:
+  // Benchmark `name`, whose body runs n operations of `flops` floating point
+  // operations each, or of an unknown count if flops is zero.
+  void add(std::string name, double flops,
+           std::function<void(std::size_t n)> body) {
+    benchmarks_.push_back({std::move(name), flops, std::move(body)});
+  }
+
+  // Adds `key` to the context of the JSON output.
+  void context(std::string key, std::string value) {
+    context_.emplace_back(std::move(key), std::move(value));
+  }
+
+  // Runs the benchmarks selected by the flags in argv, returns the exit
+  // status.
+  int run(int argc, char **argv) {
+    std::string filter = ".";
+    std::string out;
+    double min_time = 0.5;
+    for (int i = 1; i < argc; ++i) {
+      std::string arg = argv[i];
+      if (flag(arg, "--benchmark_filter=", filter) ||
+          flag(arg, "--benchmark_out=", out)) {
+        continue;
+      }
+      std::string t;
+      if (flag(arg, "--benchmark_min_time=", t)) {
+        min_time = std::atof(t.c_str());
+        continue;
+      }
+      std::fprintf(stderr, "unknown flag %s\n", arg.c_str());
+      return 1;
+    }
+    std::regex pattern(filter);
+    std::vector<result> results;
+    std::printf("%-40s %12s %12s %12s %14s\n", "Benchmark", "Time (ns)",
+                "CPU (ns)", "Flops", "Iterations");
+    for (const auto &b : benchmarks_) {
+      if (!std::regex_search(b.name, pattern)) {
+        continue;
+      }
+      auto r = measure(b, min_time);
+      std::printf("%-40s %12.2f %12.2f %12.0f %14zu\n", r.name.c_str(),
+                  r.real_time, r.cpu_time, r.flops, r.iterations);
+      results.push_back(r);
+    }
+    if (!out.empty() && !write(out, argv[0], results)) {
+      std::fprintf(stderr, "cannot write %s\n", out.c_str());
+      return 1;
+    }
+    return 0;
+  }
+
+private:
+  struct entry {
+    std::string name;
+    double flops;
+    std::function<void(std::size_t)> body;
+  };
+
+  static bool flag(const std::string &arg, const char *name,
+                   std::string &value) {
+    auto len = std::strlen(name);
+    if (arg.compare(0, len, name) != 0) {
+      return false;
+    }
+    value = arg.substr(len);
+    return true;
+  }
+
+  static result measure(const entry &b, double min_time) {
+    using clock = std::chrono::steady_clock;
+    std::size_t n = 1;
+    while (true) {
+      auto start = clock::now();
+      auto cpu = std::clock();
+      b.body(n);
+      double cpu_time = double(std::clock() - cpu) / CLOCKS_PER_SEC;
+      double real_time =
+          std::chrono::duration<double>(clock::now() - start).count();
+      if (real_time >= min_time || n >= (std::size_t(1) << 40)) {
+        return {b.name, n, 1e9 * real_time / n, 1e9 * cpu_time / n,
+                b.flops};
+      }
+      // Aim past the minimum time from the rate so far, as google-benchmark
+      // does, growing by at most a factor of ten.
+      auto scale = real_time > 0.0 ? 1.4 * min_time / real_time : 10.0;
+      n = static_cast<std::size_t>(n * std::min(std::max(scale, 2.0), 10.0));
+    }
+  }
+
+  bool write(const std::string &path, const char *executable,
+             const std::vector<result> &results) const {
+    auto f = std::fopen(path.c_str(), "w");
+    if (f == nullptr) {
+      return false;
+    }
+    char date[64];
+    auto now = std::time(nullptr);
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S%z",
+                  std::localtime(&now));
+    std::fprintf(f, "{\n  \"context\": {\n");
+    std::fprintf(f, "    \"date\": \"%s\",\n", date);
+    std::fprintf(f, "    \"executable\": \"%s\",\n", executable);
+    std::fprintf(f, "    \"compiler\": \"%s\",\n", compiler().c_str());
+    for (const auto &c : context_) {
+      std::fprintf(f, "    \"%s\": \"%s\",\n", c.first.c_str(),
+                   c.second.c_str());
+    }
+    std::fprintf(f, "    \"library_build_type\": \"%s\"\n",
+#ifdef NDEBUG
+                 "release"
+#else
+                 "debug"
+#endif
+    );
+    std::fprintf(f, "  },\n  \"benchmarks\": [\n");
+    for (std::size_t i = 0; i < results.size(); ++i) {
+      const auto &r = results[i];
+      std::fprintf(f, "    {\n");
+      std::fprintf(f, "      \"name\": \"%s\",\n", r.name.c_str());
+      std::fprintf(f, "      \"run_name\": \"%s\",\n", r.name.c_str());
+      std::fprintf(f, "      \"run_type\": \"iteration\",\n");
+      std::fprintf(f, "      \"iterations\": %zu,\n", r.iterations);
+      std::fprintf(f, "      \"real_time\": %.6e,\n", r.real_time);
+      std::fprintf(f, "      \"cpu_time\": %.6e,\n", r.cpu_time);
+      std::fprintf(f, "      \"time_unit\": \"ns\",\n");
+      std::fprintf(f, "      \"flops\": %.0f\n", r.flops);
+      std::fprintf(f, "    }%s\n", i + 1 < results.size() ? "," : "");
+    }
+    std::fprintf(f, "  ]\n}\n");
+    return std::fclose(f) == 0;
+  }
+
+  static std::string compiler() {
+#if defined(__clang__)
+    return "clang " __clang_version__;
+#elif defined(__GNUC__)
+    return "gcc " __VERSION__;
+#else
+    return "unknown";
+#endif
+  }
+
+  std::vector<entry> benchmarks_;
+  std::vector<std::pair<std::string, std::string>> context_;
+};
+
+} // namespace benchmark
+
+} // namespace pyversor
@@ -0,0 +1,371 @@
+// Copyright (c) 2015, Lars Tingelstad
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of pyversor nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+// Microbenchmarks of the c3d products bound in Python and of those compiled
+// into the library for its own use (see include/pyversor/c3d/instantiations.h),
+// the versor generators and logarithms, splits and meets, and the batched
+// kernels.
+//
+//   pyversor_benchmarks --benchmark_out=results.json
+
+#include "benchmark.h"
+
+#include <pyversor/c3d/instantiations.h>
+#include <pyversor/c3d/kernels.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+using namespace vsr::cga;
+using pyversor::benchmark::do_not_optimize;
+using pyversor::benchmark::runner;
+namespace kernels = pyversor::c3d::kernels;
+
+// Inputs per benchmark, cycled through by the loops so that no result can be
+// hoisted out of them.
+constexpr std::size_t pool = 64;
+
+std::mt19937 &engine() {
+  static std::mt19937 e(1);
+  return e;
+}
+
+double uniform() {
+  std::uniform_real_distribution<double> u(-1.0, 1.0);
+  return u(engine());
+}
+
+// Elements of T with coefficients in [-1, 1].
+template <typename T> std::vector<T> random() {
+  std::vector<T> out(pool);
+  for (auto &x : out) {
+    for (int i = 0; i < T::Num; ++i) {
+      x[i] = uniform();
+    }
+  }
+  return out;
+}
+
+// f of the elements of `in`.
+template <typename T, typename F> auto map(const std::vector<T> &in, F f) {
+  std::vector<decltype(f(in[0]))> out;
+  for (const auto &x : in) {
+    out.push_back(f(x));
+  }
+  return out;
+}
+
+// Coefficients of the elements of `in`, one after the other.
+template <typename T> std::vector<double> flatten(const std::vector<T> &in) {
+  std::vector<double> out;
+  for (const auto &x : in) {
+    out.insert(out.end(), x.val.begin(), x.val.end());
+  }
+  return out;
+}
+
+Pnt point() { return Round::null(uniform(), uniform(), uniform()); }
+
+std::vector<Par> pairs() {
+  std::vector<Par> out;
+  for (std::size_t i = 0; i < pool; ++i) {
+    out.push_back(point() ^ point());
+  }
+  return out;
+}
+
+std::vector<Dls> spheres() {
+  std::vector<Dls> out;
+  for (std::size_t i = 0; i < pool; ++i) {
+    out.push_back(Round::dls(Vec(uniform(), uniform(), uniform()),
+                             1.0 + 0.5 * uniform()));
+  }
+  return out;
+}
+
+// Floating point operations of the bilinear map f, evaluated term by term:
+// each product of coefficients of A and B that reaches a coefficient of the
+// result is a multiplication, and all but the first on each coefficient are
+// additions. The terms are found by applying f to pairs of basis blades.
+template <typename A, typename B, typename F> double bilinear(F f) {
+  using R = decltype(f(A(), B()));
+  std::vector<bool> reached(R::Num, false);
+  double products = 0.0;
+  for (int i = 0; i < A::Num; ++i) {
+    for (int j = 0; j < B::Num; ++j) {
+      A a;
+      B b;
+      a[i] = 1.0;
+      b[j] = 1.0;
+      auto r = f(a, b);
+      for (int k = 0; k < R::Num; ++k) {
+        if (r[k] != 0.0) {
+          products += 1.0;
+          reached[k] = true;
+        }
+      }
+    }
+  }
+  return 2.0 * products - std::count(reached.begin(), reached.end(), true);
+}
+
+// Floating point operations of the sandwich of A by V, V x ~V, evaluated as
+// the product V x followed by the coefficients of A of its product with ~V.
+template <typename A, typename V> double sandwich() {
+  using T = decltype(V() * A());
+  return bilinear<V, A>([](const V &v, const A &a) { return v * a; }) +
+         bilinear<T, V>([](const T &t, const V &v) {
+           return (t * ~v).template cast<A>();
+         });
+}
+
+// Benchmark of f over the elements of a and b.
+template <typename A, typename B, typename F>
+void binary(runner &r, const std::string &name, double flops,
+            std::vector<A> a, std::vector<B> b, F f) {
+  r.add(name, flops, [a, b, f](std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i) {
+      auto k = i % pool;
+      do_not_optimize(f(a[k], b[k]));
+    }
+  });
+}
+
+template <typename A, typename F>
+void unary(runner &r, const std::string &name, std::vector<A> a, F f) {
+  r.add(name, 0.0, [a, f](std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i) {
+      do_not_optimize(f(a[i % pool]));
+    }
+  });
+}
+
+// The full multivector of the bindings, c3d::multivector_t.
+using Mvc = vsr::Multivector<
+    vsr::algebra<vsr::metric<4, 1, true>, double>,
+    vsr::Basis<0, 1, 2, 4, 8, 16, 3, 5, 6, 9, 10, 12, 17, 18, 20, 24, 7, 11, 13,
+               14, 19, 21, 22, 25, 26, 28, 15, 23, 27, 29, 30, 31>>;
+
+// The products of the def_geometric_product, def_outer_product and
+// def_inner_product bindings in src/c3d, by the vsr::cga names of their types
+// (c3d::vector_t is Pnt, bivector_t Par, trivector_t Cir, quadvector_t Sph
+// and ega::rotator_t Rot), followed by those of instantiations.h that are not
+// bound. Keep in step with the bindings.
+#define PYVERSOR_BENCHMARK_GEOMETRIC_PRODUCTS(X)                               \
+  X(Pnt, Pnt)                                                                  \
+  X(Pnt, Par)                                                                  \
+  X(Par, Par)                                                                  \
+  X(Cir, Cir)                                                                  \
+  X(Sph, Sph)                                                                  \
+  X(Mvc, Mvc)                                                                  \
+  X(Rot, Rot)                                                                  \
+  X(Rot, Trs)                                                                  \
+  X(Rot, Mot)                                                                  \
+  X(Trs, Rot)                                                                  \
+  X(Trs, Trs)                                                                  \
+  X(Trs, Mot)                                                                  \
+  X(Mot, Rot)                                                                  \
+  X(Mot, Trs)                                                                  \
+  X(Mot, Mot)                                                                  \
+  X(Mot, Dll)                                                                  \
+  X(Dll, Mot)                                                                  \
+  X(Dll, Dll)                                                                  \
+  X(Lin, Lin)                                                                  \
+  X(Flp, Flp)                                                                  \
+  X(Bst, Bst)                                                                  \
+  X(Con, Con)
+
+// Bound geometric products whose binding casts them, X(A, B, C) for C(A * B).
+#define PYVERSOR_BENCHMARK_CAST_GEOMETRIC_PRODUCTS(X)                          \
+  X(Dlp, Dlp, Mot)                                                             \
+  X(Pln, Pln, Mot)
+
+#define PYVERSOR_BENCHMARK_OUTER_PRODUCTS(X)                                   \
+  X(Mvc, Mvc)                                                                  \
+  X(Pnt, Pnt)                                                                  \
+  X(Par, Pnt)                                                                  \
+  X(Cir, Pnt)                                                                  \
+  X(Pnt, Inf)                                                                  \
+  X(Par, Inf)                                                                  \
+  X(Cir, Inf)
+
+#define PYVERSOR_BENCHMARK_INNER_PRODUCTS(X)                                   \
+  X(Pnt, Pnt)                                                                  \
+  X(Pnt, Par)                                                                  \
+  X(Mvc, Mvc)                                                                  \
+  X(Pnt, Cir)                                                                  \
+  X(Pnt, Sph)                                                                  \
+  X(Dll, Dll)
+
+void products(runner &r) {
+#define PYVERSOR_BENCHMARK_PRODUCT(NAME, OP, A, B, C)                          \
+  {                                                                            \
+    auto f = [](const A &a, const B &b) { return C(a OP b); };                 \
+    binary(r, NAME "/" #A #OP #B, bilinear<A, B>(f), random<A>(),              \
+           random<B>(), f);                                                    \
+  }
+#define PYVERSOR_BENCHMARK_GP(A, B)                                            \
+  PYVERSOR_BENCHMARK_PRODUCT("gp", *, A, B, decltype(A() * B()))
+#define PYVERSOR_BENCHMARK_CAST_GP(A, B, C)                                    \
+  PYVERSOR_BENCHMARK_PRODUCT("gp", *, A, B, C)
+#define PYVERSOR_BENCHMARK_OP(A, B)                                            \
+  PYVERSOR_BENCHMARK_PRODUCT("op", ^, A, B, decltype(A() ^ B()))
+#define PYVERSOR_BENCHMARK_IP(A, B)                                            \
+  PYVERSOR_BENCHMARK_PRODUCT("ip", <=, A, B, decltype(A() <= B()))
+  PYVERSOR_BENCHMARK_GEOMETRIC_PRODUCTS(PYVERSOR_BENCHMARK_GP)
+  PYVERSOR_BENCHMARK_CAST_GEOMETRIC_PRODUCTS(PYVERSOR_BENCHMARK_CAST_GP)
+  PYVERSOR_BENCHMARK_OUTER_PRODUCTS(PYVERSOR_BENCHMARK_OP)
+  PYVERSOR_BENCHMARK_INNER_PRODUCTS(PYVERSOR_BENCHMARK_IP)
+#undef PYVERSOR_BENCHMARK_GP
+#undef PYVERSOR_BENCHMARK_CAST_GP
+#undef PYVERSOR_BENCHMARK_OP
+#undef PYVERSOR_BENCHMARK_IP
+#undef PYVERSOR_BENCHMARK_PRODUCT
+}
+
+// Reflections of rounds and flats in dual planes and dual spheres, and of
+// lines in lines as in Construct::meet of two lines.
+#define PYVERSOR_BENCHMARK_REFLECTIONS(X)                                      \
+  X(Pnt, Dlp)                                                                  \
+  X(Par, Dlp)                                                                  \
+  X(Cir, Dlp)                                                                  \
+  X(Sph, Dlp)                                                                  \
+  X(Lin, Dlp)                                                                  \
+  X(Dll, Dlp)                                                                  \
+  X(Pnt, Dls)                                                                  \
+  X(Par, Dls)                                                                  \
+  X(Cir, Dls)                                                                  \
+  X(Lin, Lin)
+
+void sandwiches(runner &r) {
+#define PYVERSOR_BENCHMARK_SPIN(A, V)                                          \
+  binary(r, "spin/" #A ".spin(" #V ")", sandwich<A, V>(), random<A>(),        \
+         random<V>(), [](const A &a, const V &v) { return a.spin(v); });
+#define PYVERSOR_BENCHMARK_REFLECT(A, V)                                       \
+  binary(r, "reflect/" #A ".reflect(" #V ")", sandwich<A, V>(), random<A>(),  \
+         random<V>(), [](const A &a, const V &v) { return a.reflect(v); });
+  PYVERSOR_C3D_SPINS(PYVERSOR_BENCHMARK_SPIN)
+  PYVERSOR_BENCHMARK_REFLECTIONS(PYVERSOR_BENCHMARK_REFLECT)
+  // The bindings spin tangent vectors as point pairs.
+  binary(r, "spin/Tnv.spin(Trs)", sandwich<Par, Trs>(), random<Tnv>(),
+         random<Trs>(), [](const Tnv &a, const Trs &v) {
+           return Par(a).spin(v);
+         });
+#undef PYVERSOR_BENCHMARK_SPIN
+#undef PYVERSOR_BENCHMARK_REFLECT
+}
+
+void generators(runner &r) {
+  auto dll = random<Dll>();
+  auto biv = random<Biv>();
+  auto par = pairs();
+  unary(r, "exp/Gen::mot(Dll)", dll, [](const Dll &d) { return Gen::mot(d); });
+  unary(r, "exp/Gen::rot(Biv)", biv, [](const Biv &b) { return Gen::rot(b); });
+  unary(r, "exp/Gen::trs(Drv)", random<Drv>(),
+        [](const Drv &d) { return Gen::trs(d); });
+  unary(r, "exp/Gen::bst(Par)", par, [](const Par &p) { return Gen::bst(p); });
+  unary(r, "exp/Gen::dil(Pnt)", map(par, [](const Par &) { return point(); }),
+        [](const Pnt &p) { return Gen::dil(p, 0.5); });
+  unary(r, "log/Gen::log(Mot)", map(dll, [](const Dll &d) {
+          return Gen::mot(d);
+        }),
+        [](const Mot &m) { return Gen::log(m); });
+  unary(r, "log/Gen::log(Rot)", map(biv, [](const Biv &b) {
+          return Gen::rot(b);
+        }),
+        [](const Rot &m) { return Gen::log(m); });
+}
+
+void constructions(runner &r) {
+  auto dls = spheres();
+  auto lines = map(pairs(), [](const Par &p) { return Lin(p ^ Inf(1)); });
+  auto dual_lines = map(lines, [](const Lin &l) { return Dll(l.dual()); });
+  auto planes = map(random<Vec>(), [](const Vec &v) {
+    return Dlp(v[0], v[1], v[2], 0.5 * uniform());
+  });
+  unary(r, "split/Round::split(Par)", pairs(),
+        [](const Par &p) { return Round::split(p); });
+  binary(r, "meet/Construct::meet(Dls,Dls)", 0.0, dls, spheres(),
+         [](const Dls &a, const Dls &b) { return Construct::meet(a, b); });
+  binary(r, "meet/Construct::meet(Dll,Dls)", 0.0, dual_lines, dls,
+         [](const Dll &a, const Dls &b) { return Construct::meet(a, b); });
+  binary(r, "meet/Construct::meet(Dll,Dlp)", 0.0, dual_lines, planes,
+         [](const Dll &a, const Dlp &b) { return Construct::meet(a, b); });
+  binary(r, "meet/Construct::meet(Lin,Lin)", 0.0, lines,
+         map(pairs(), [](const Par &p) { return Lin(p ^ Inf(1)); }),
+         [](const Lin &a, const Lin &b) { return Construct::meet(a, b); });
+}
+
+// Batched kernels of the selected instruction set, per element.
+void batched(runner &r) {
+  auto dll = random<Dll>();
+  auto mot = flatten(map(dll, [](const Dll &d) { return Gen::mot(d); }));
+  auto pnt = flatten(map(dll, [](const Dll &) { return point(); }));
+  auto par = flatten(pairs());
+  auto lines = flatten(dll);
+  auto add = [&r](const std::string &name, std::size_t size,
+                  std::function<void(std::size_t, double *)> f) {
+    r.add(name, 0.0, [size, f](std::size_t n) {
+      std::vector<double> out(size * pool);
+      for (std::size_t i = 0; i < n; i += pool) {
+        f(std::min(pool, n - i), out.data());
+        do_not_optimize(out[0]);
+      }
+    });
+  };
+  const auto &k = kernels::get();
+  add("batch/motor_exp", 8, [&k, lines](std::size_t n, double *out) {
+    k.motor_exp(n, lines.data(), out);
+  });
+  add("batch/motor_log", 6, [&k, mot](std::size_t n, double *out) {
+    k.motor_log(n, mot.data(), out);
+  });
+  add("batch/motor_spin", 5, [&k, pnt, mot](std::size_t n, double *out) {
+    k.motor_spin(n, pnt.data(), 5, mot.data(), 8, out);
+  });
+  add("batch/boost_spin", 5, [&k, pnt, par](std::size_t n, double *out) {
+    k.boost_spin(n, pnt.data(), 5, par.data(), 10, out);
+  });
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  runner r;
+  r.context("isa", kernels::get().isa);
+  products(r);
+  sandwiches(r);
+  generators(r);
+  constructions(r);
+  batched(r);
+  return r.run(argc, argv);
+}
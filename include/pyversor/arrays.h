@@ -0,0 +1,80 @@
+// Copyright (c) 2015, Lars Tingelstad
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of pyversor nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+
+#include <string>
+#include <vector>
+
+namespace pyversor {
+
+namespace py = pybind11;
+
+// Batches of multivectors are passed as C-contiguous float64 arrays whose last
+// axis holds the coefficients of one element, in the order of `toarray()`.
+using array_t = py::array_t<double, py::array::c_style | py::array::forcecast>;
+
+// Number of elements in `a`, checking that its last axis has `num`
+// coefficients.
+inline std::size_t batch_size(const array_t &a, py::ssize_t num,
+                              const char *name) {
+  if (a.ndim() < 1 || a.shape(a.ndim() - 1) != num) {
+    throw py::value_error(std::string(name) + " must have shape (..., " +
+                          std::to_string(num) + ")");
+  }
+  return static_cast<std::size_t>(a.size() / num);
+}
+
+// Shape of the batch of `a`, without the coefficient axis.
+inline std::vector<py::ssize_t> batch_shape(const array_t &a) {
+  return std::vector<py::ssize_t>(a.shape(), a.shape() + a.ndim() - 1);
+}
+
+// Uninitialized array with the leading shape of `a` and `num` coefficients in
+// the last axis.
+inline array_t batch_like(const array_t &a, py::ssize_t num) {
+  auto shape = batch_shape(a);
+  shape.push_back(num);
+  return array_t(shape);
+}
+
+// Number of elements of a binary operation where either operand may be a
+// single element that is broadcast over the other.
+inline std::size_t broadcast_size(std::size_t na, std::size_t nb) {
+  if (na != nb && na != 1 && nb != 1) {
+    throw py::value_error("Batch sizes " + std::to_string(na) + " and " +
+                          std::to_string(nb) + " do not match");
+  }
+  return na == 1 ? nb : na;
+}
+
+} // namespace pyversor
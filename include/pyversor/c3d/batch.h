@@ -0,0 +1,63 @@
+// Copyright (c) 2015, Lars Tingelstad
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of pyversor nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+#include <pyversor/arrays.h>
+#include <pyversor/c3d/convert.h>
+#include <pyversor/c3d/hyperbolic.h>
+#include <pyversor/c3d/kernels.h>
+#include <pyversor/c3d/raycast.h>
+#include <pyversor/c3d/sampling.h>
+
+#include <vector>
+
+namespace pyversor {
+
+namespace py = pybind11;
+
+namespace c3d {
+
+void def_batch(py::module &m);
+
+// Dual lines of the batch `lines`, which holds dual_line_t if `dual` and line_t
+// if not.
+std::vector<double> dual_lines(const array_t &lines, bool dual);
+
+// Start points of rays along `m` lines, (m, 3), or null if `origins` is None.
+// `storage` keeps the converted array alive.
+const double *ray_origins(const py::object &origins, std::size_t m,
+                          array_t &storage);
+
+} // namespace c3d
+
+} // namespace pyversor
@@ -0,0 +1,95 @@
+// Copyright (c) 2015, Lars Tingelstad
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of pyversor nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace pyversor {
+
+namespace c3d {
+
+// Conformal rotor path through the split log L = Gen::log(C) of a conformal
+// rotor C: C(t) is the product of the boosts Gen::bst(t L_i) of the one or two
+// commuting point pairs of the log, so that C(0) is the identity and C(1) is C
+// itself. Gen::con(L, t) boosts by -t L_i and gives the reverse of C(t). The
+// log is taken once, on construction.
+//
+// Points are transformed through the 5 x 5 matrix of the spin by C(t), so
+// each parameter value costs a few boosts and spins of basis vectors
+// regardless of the number of points.
+class blend {
+public:
+  // Path of the conformal rotor Gen::ratio(a, b, flip) between two direct
+  // circles (10 coefficients each), which takes a to b.
+  static blend circles(const double *a, const double *b, bool flip = false);
+
+  // Path of the conformal rotor `con` (16 coefficients).
+  explicit blend(const double *con);
+
+  // Number of point pairs in the split log, one or two, and their
+  // coefficients (10 each).
+  std::size_t size() const { return size_; }
+  const double *log() const { return log_[0]; }
+
+  // Conformal rotors (16 coefficients) at the `m` parameter values in t.
+  void evaluate(std::size_t m, const double *t, double *out) const;
+
+  // Spin of the `n` conformal points in p (5 coefficients) by the rotor at
+  // each of the `m` parameter values in t, scaled to unit origin
+  // coefficient: m x n points in out.
+  void apply(std::size_t m, const double *t, std::size_t n, const double *p,
+             double *out) const;
+
+private:
+  blend() = default;
+
+  // 5 x 5 matrix of the spin by the rotor at t, row major.
+  void spin_matrix(double t, double *out) const;
+
+  double log_[2][10] = {};
+  std::size_t size_ = 0;
+};
+
+// Gen::split of `n` bivectors (10 coefficients) into commuting point pairs,
+// two (2 x 10) per bivector with the second zero when there is only one, and
+// the number of pairs of each in count if it is not null. A bivector that
+// cannot be split gets two NaN pairs.
+void split_pairs(std::size_t n, const double *par, double *out,
+                 std::int64_t *count);
+
+// Gen::log of `n` conformal rotors (16 coefficients), laid out as the pairs of
+// split_pairs.
+void split_logs(std::size_t n, const double *con, double *out,
+                std::int64_t *count);
+
+} // namespace c3d
+
+} // namespace pyversor
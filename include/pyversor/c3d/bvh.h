@@ -0,0 +1,123 @@
+// Copyright (c) 2015, Lars Tingelstad
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of pyversor nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace pyversor {
+
+namespace c3d {
+
+// Bounding volume hierarchy over dual spheres, circles, point pairs or bounded
+// planes. The bounds of each primitive are the box around the sphere at its
+// Round::location with its Round::radius, and the hierarchy is a linear BVH
+// built in parallel from the Morton codes of those locations.
+//
+// Dual spheres are hit on their surface. Circles are the discs they bound, and
+// a bounded plane is the disc where a dual plane meets a bounding dual sphere,
+// Construct::meet. Point pairs are their two points and are never hit by rays.
+// The leaf tests use the conformal inner product on normalized dual spheres
+// and dual planes. A hierarchy holds fewer than 2^31 primitives.
+class bvh {
+public:
+  enum class kind { dual_sphere, circle, pair };
+
+  // Hierarchies over `n` dual spheres (5 coefficients), direct circles (10),
+  // direct point pairs (10) and dual planes (4) bounded by dual spheres (5).
+  static bvh dual_spheres(std::size_t n, const double *s);
+  static bvh circles(std::size_t n, const double *cir);
+  static bvh pairs(std::size_t n, const double *par);
+  static bvh planes(std::size_t n, const double *dlp, const double *bounds);
+
+  kind primitives() const { return kind_; }
+  std::size_t size() const { return prims_.size(); }
+
+  // First primitive hit by each of the `m` rays, with the conventions of
+  // raycast::nearest.
+  void raycast(std::size_t m, const double *dll, const double *origin,
+               std::int64_t *index, double *distance) const;
+
+  // Primitives overlapping each of the `m` dual spheres, in the compressed
+  // layout: the primitives of sphere i are indices[offsets[i]:offsets[i + 1]].
+  void overlap(std::size_t m, const double *s,
+               std::vector<std::int64_t> &offsets,
+               std::vector<std::int64_t> &indices) const;
+
+  // Closest primitive to each of the `m` euclidean points (3 coefficients),
+  // and the distance to it.
+  void nearest(std::size_t m, const double *x, std::int64_t *index,
+               double *distance) const;
+
+private:
+  struct primitive {
+    // Normalized dual sphere around the primitive, the sphere itself for dual
+    // spheres, and its radius.
+    double sphere[5];
+    double radius;
+    // Normalized dual plane of a disc, or the first point of a pair.
+    double plane[5];
+    // Second point of a pair.
+    double point[5];
+  };
+
+  // Internal nodes come first, followed by one leaf per primitive in Morton
+  // order. An internal node holds the boxes of both children, rounded outwards
+  // to float so that a node fits in a cache line.
+  struct node {
+    float lo[2][3];
+    float hi[2][3];
+    std::int32_t child[2];
+  };
+
+  bvh(kind k, std::vector<primitive> prims);
+
+  void build();
+
+  bool is_leaf(std::int64_t i) const {
+    return i >= static_cast<std::int64_t>(prims_.size()) - 1;
+  }
+  std::int64_t leaf_primitive(std::int64_t i) const {
+    return order_[i - static_cast<std::int64_t>(prims_.size()) + 1];
+  }
+
+  kind kind_;
+  std::vector<primitive> prims_;
+  std::vector<std::int64_t> order_;
+  std::vector<node> nodes_;
+  // Box of the root, node 0.
+  float lo_[3];
+  float hi_[3];
+};
+
+} // namespace c3d
+
+} // namespace pyversor
@@ -0,0 +1,100 @@
+// Copyright (c) 2015, Lars Tingelstad
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of pyversor nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace pyversor {
+
+namespace c3d {
+
+// Serial kinematic chain of joints with dual line screw axes L_i, evaluated as
+// the product of exponentials: the motor of link i for joint values theta is
+//   M_i = Gen::mot(theta_1 L_1) ... Gen::mot(theta_i L_i)
+// and the end effector motor is M_J H for the home motor H. With the versor
+// convention a unit axis turns by 2 theta, so axes scaled by one half take
+// angles in radians; a prismatic joint is an axis at infinity.
+class chain {
+public:
+  // Chain of `joints` joints with the axes in dll (6 coefficients each) and
+  // the home motor (8), or the identity if home is null. Throws
+  // std::invalid_argument if there are no joints.
+  chain(std::size_t joints, const double *dll, const double *home = nullptr);
+
+  std::size_t size() const { return axes_.size() / 6; }
+  const double *axes() const { return axes_.data(); }
+  const double *home() const { return home_; }
+
+  // Link motors (joints x 8 per configuration) and end effector motors (8)
+  // of `m` configurations of the joint values in theta (one per joint),
+  // either of which may be null. Configurations are evaluated in order and
+  // the prefix products M_1 ... M_k are reused from the previous
+  // configuration while its first k joint values are unchanged.
+  void forward(std::size_t m, const double *theta, double *links,
+               double *end) const;
+
+  // Geometric Jacobian of `m` configurations in screw form: joints x 6 per
+  // configuration, where column i is the axis of joint i transported through
+  // the motor of the link before it, M_{i-1} L_i ~M_{i-1}. A change of the
+  // joint values d theta moves the end effector motor M to
+  // Gen::mot(sum d theta_i J_i) M to first order.
+  void jacobian(std::size_t m, const double *theta, double *out) const;
+
+  struct inverse_options {
+    // Damping lambda of the least squares steps.
+    double damping = 1e-3;
+    // Norm of the motor log error at which a solve stops.
+    double tolerance = 1e-10;
+    std::size_t max_iterations = 100;
+  };
+
+  // Joint values reaching each of the `m` target end effector motors (8),
+  // by damped least squares on the error Gen::log(target ~M), with
+  // target ~M negated when its scalar part is negative since both signs are
+  // the same pose, starting from and written to theta. The norm of the final
+  // error and the number of iterations of each solve are written to residual
+  // and iterations, either of which may be null; the residual is NaN if a
+  // step could not be solved even with the damping raised.
+  void inverse(std::size_t m, const double *targets, double *theta,
+               const inverse_options &opts, double *residual,
+               std::size_t *iterations) const;
+
+private:
+  // Link and end effector motors of a single configuration.
+  void evaluate(const double *theta, double *links, double *end) const;
+
+  std::vector<double> axes_;
+  double home_[8];
+};
+
+} // namespace c3d
+
+} // namespace pyversor
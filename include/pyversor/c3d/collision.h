@@ -0,0 +1,67 @@
+// Copyright (c) 2015, Lars Tingelstad
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of pyversor nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace pyversor {
+
+namespace c3d {
+
+// Overlap tests between sets of dual spheres. Spheres are normalized at
+// Round::location with Round::radius, as in the bounds of a bvh, and two of
+// them touch or overlap when the conformal inner product of the normalized
+// dual spheres is at least minus the product of their radii.
+//
+// The broad phase sorts and sweeps the intervals the spheres cover along the
+// axis on which their centers spread the most, so only spheres whose intervals
+// overlap reach the inner product test. The sweep is spread over the worker
+// threads, and pairs are returned sorted, first by the index of the first
+// sphere and then by that of the second.
+namespace collision {
+
+// Pairs i < j of the `n` dual spheres in s (5 coefficients) that overlap, as
+// first[k], second[k].
+void pairs(std::size_t n, const double *s, std::vector<std::int64_t> &first,
+           std::vector<std::int64_t> &second);
+
+// Pairs of the `n` dual spheres in a and the `m` dual spheres in b that
+// overlap, with the index into a in first and the index into b in second.
+void pairs(std::size_t n, const double *a, std::size_t m, const double *b,
+           std::vector<std::int64_t> &first,
+           std::vector<std::int64_t> &second);
+
+} // namespace collision
+
+} // namespace c3d
+
+} // namespace pyversor
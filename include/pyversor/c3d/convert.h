@@ -0,0 +1,99 @@
+// Copyright (c) 2015, Lars Tingelstad
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of pyversor nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <cstddef>
+
+namespace pyversor {
+
+namespace c3d {
+
+// Conversions between versors and matrices for interop with graphics and
+// linear algebra code. Matrices are row major with `rows` rows of `cols`
+// doubles: 3 by 3 rotations, or 3 by 4 and 4 by 4 homogeneous transforms of
+// column vectors, whose last row is (0, 0, 0, 1). Each element of a versor
+// array is stored as by `toarray()`: 4 coefficients for rotators, 8 for
+// motors, 4 for translators and 2 for dilators. A versor V maps to the matrix
+// of X -> V X ~V on euclidean points.
+namespace convert {
+
+// Matrices of rotators (m_inc 4) or motors (m_inc 8). Rotators give no
+// translation, and 3 by 3 matrices drop that of motors.
+void motor_matrix(std::size_t n, const double *m, std::size_t m_inc,
+                  std::size_t rows, std::size_t cols, double *out);
+
+// Unit rotators (out_inc 4) or motors (out_inc 8) of matrices, whose
+// rotation block is expected to be orthonormal up to round-off. Motors of 3
+// by 3 matrices are pure rotations.
+void matrix_motor(std::size_t n, const double *x, std::size_t rows,
+                  std::size_t cols, double *out, std::size_t out_inc);
+
+// Homogeneous matrices (cols 4) of translators.
+void translator_matrix(std::size_t n, const double *t, std::size_t rows,
+                       double *out);
+
+// Translators of the fourth column of homogeneous matrices.
+void matrix_translator(std::size_t n, const double *x, std::size_t rows,
+                       double *out);
+
+// Homogeneous matrices (cols 4) of dilators about the origin.
+void dilator_matrix(std::size_t n, const double *d, std::size_t rows,
+                    double *out);
+
+// Dilators about the origin by the cube root of the determinant of the 3 by
+// 3 block of each matrix, which must be positive.
+void matrix_dilator(std::size_t n, const double *x, std::size_t rows,
+                    std::size_t cols, double *out);
+
+// Quaternions (w, x, y, z) of rotators and back. The rotator
+// (s, e12, e13, e23) is the quaternion (s, -e23, e13, -e12).
+void rotator_quaternion(std::size_t n, const double *r, double *out);
+void quaternion_rotator(std::size_t n, const double *q, double *out);
+
+// Rotators Gen::rot(yaw, pitch, roll) of Euler angles (3 doubles), the
+// products of the rotations by yaw in the xz plane, pitch in the yz plane and
+// roll in the xy plane, so that roll acts first. They are expanded in the
+// half angles instead of composing three exponentials.
+void euler_rotator(std::size_t n, const double *a, double *out);
+
+// Rotators Gen::rot(theta, phi) of spherical coordinates (2 doubles), which
+// are those of the Euler angles (theta, 0, phi).
+void spherical_rotator(std::size_t n, const double *a, double *out);
+
+// Euler angles (yaw, pitch, roll) of rotators of any norm, with pitch in
+// [-pi / 2, pi / 2]. At pitch +-pi / 2 yaw and roll turn about the same axis,
+// and roll is taken as zero.
+void rotator_euler(std::size_t n, const double *r, double *out);
+
+} // namespace convert
+
+} // namespace c3d
+
+} // namespace pyversor
@@ -0,0 +1,98 @@
+// Copyright (c) 2015, Lars Tingelstad
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of pyversor nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace pyversor {
+
+namespace c3d {
+
+// Fields of the smallest distance to a set of primitives, and of the
+// primitive that attains it, over point arrays and regular grids, as used for
+// voxel collision maps. Targets are conformal vectors (5 coefficients) as in
+// raycast, dual spheres or dual planes when their origin coefficient is zero,
+// and lines are dual lines (6 coefficients).
+//
+// Points are taken in tiles spread over num_threads() threads, and each tile
+// is evaluated against one primitive at a time by kernels::table::field, a
+// loop over the coordinate arrays of the tile that the compiler vectorizes.
+namespace field {
+
+enum class model { sphere, plane, line };
+
+// What the field measures. The distance is |x - c| - r to a sphere and the
+// distance to a line. The inner measure is minus the inner product X . S of
+// the normalized point and target, (|x - c|^2 - r^2) / 2 for a sphere, and
+// half the squared distance to a line. Both are d - x . n for a unit dual
+// plane (n, d), so that, as for spheres, they are negative where X . S > 0,
+// the side the normal of the plane points to.
+enum class measure { distance, inner };
+
+// Targets and lines of a field, with indices in that order. Imaginary spheres
+// act as points at their centers.
+class primitives {
+public:
+  primitives(std::size_t n, const double *s, std::size_t l,
+             const double *dll);
+
+  std::size_t size() const { return models_.size(); }
+
+  // Lowers value[i] to the field of the primitives at the `m` points with
+  // coordinates x, y, z, one array each, and sets index[i] to the primitive
+  // where it does.
+  void evaluate(std::size_t m, const double *x, const double *y,
+                const double *z, measure f, double *value,
+                std::int64_t *index) const;
+
+private:
+  std::vector<model> models_;
+  // 6 parameters per primitive, see kernels::table::field.
+  std::vector<double> params_;
+};
+
+// Field at the `m` points x (3 coefficients), infinity with index -1 if there
+// are no primitives.
+void points(std::size_t m, const double *x, const primitives &p, measure f,
+            double *value, std::int64_t *index);
+
+// Field at the points origin + spacing * (i, j, k) of the grid of `shape`
+// (3) points, stored in C order.
+void grid(const double *origin, const double *spacing,
+          const std::size_t *shape, const primitives &p, measure f,
+          double *value, std::int64_t *index);
+
+} // namespace field
+
+} // namespace c3d
+
+} // namespace pyversor
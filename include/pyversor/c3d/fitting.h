@@ -0,0 +1,103 @@
+// Copyright (c) 2015, Lars Tingelstad
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of pyversor nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace pyversor {
+
+namespace c3d {
+
+// Streaming least squares fits of dual spheres and dual planes to weighted
+// points, for k independent fits at once.
+//
+// Points are added chunk by chunk and only their moments are kept: the sums of
+// w X X^T over the null points X = Round::null(x), taken relative to the first
+// point of each fit to keep them well conditioned. A dual sphere s is fitted by
+// minimizing the sum of w (X . s)^2 subject to s . s = 1, the smallest
+// positive eigenvalue of the generalized problem A s = l M s, with A the
+// moment matrix seen through the conformal metric M. On that normalization
+// X . s is the distance of x to the sphere to first order, and degenerates
+// to the distance to a plane when the points are coplanar. A dual plane is
+// fitted by the total least squares plane through the weighted mean.
+//
+// A fitter is not safe to use from several threads at once, but each call
+// to `add` is spread over the worker threads of parallel_for.
+class fitter {
+public:
+  explicit fitter(std::size_t k = 1);
+
+  std::size_t size() const { return k_; }
+
+  // Adds the `n` euclidean points in x (3 coefficients) with weights w, or
+  // ones if w is null, to the fits given by labels, or to fit 0 if labels is
+  // null. Throws std::out_of_range for labels outside [0, k).
+  void add(std::size_t n, const double *x, const double *w,
+           const std::int64_t *labels);
+
+  // Forgets every point added so far.
+  void reset();
+
+  // Total weight added to each fit.
+  void weights(double *out) const;
+
+  // Fitted dual sphere of each fit (5 coefficients) scaled to a unit origin
+  // coefficient, as Round::dls, and the root mean square distance of its
+  // points to the sphere. A fit without weight gives NaN.
+  void spheres(double *s, double *rms) const;
+
+  // Fitted dual plane of each fit (4 coefficients, unit normal) and the root
+  // mean square distance of its points to the plane.
+  void planes(double *dlp, double *rms) const;
+
+private:
+  static constexpr std::size_t moments = 15;
+
+  std::size_t k_;
+  // Origin of the moments of each fit, its first point.
+  std::vector<bool> seen_;
+  std::vector<double> origins_;
+  std::vector<double> sums_;
+};
+
+// Signed distance of each of the `n` euclidean points in x to its target,
+// positive outside a sphere and on the side of the normal of a plane. Targets
+// are dual spheres (width 5) or dual planes (width 4). The target of point i
+// is targets[labels[i]] if labels is not null, and otherwise the element
+// `inc` doubles further for every point, so that 0 broadcasts one target.
+void residuals(std::size_t n, const double *x, std::size_t width,
+               const double *targets, std::size_t inc,
+               const std::int64_t *labels, double *out);
+
+} // namespace c3d
+
+} // namespace pyversor
@@ -29,11 +29,14 @@
 
 #pragma once
 
+#include <pybind11/numpy.h>
 #include <pybind11/pybind11.h>
 
 #include <versor/space/cga3D_op.h>
 #include <versor/space/cga3D_round.h>
 
+#include <pyversor/arrays.h>
+#include <pyversor/c3d/blend.h>
 #include <pyversor/c3d/types.h>
 
 namespace pyversor {
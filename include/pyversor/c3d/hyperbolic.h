@@ -0,0 +1,94 @@
+// Copyright (c) 2015, Lars Tingelstad
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of pyversor nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace pyversor {
+
+namespace c3d {
+
+// Hyperbolic geometry in the conformal ball model, in which the unit dual
+// sphere EP at the origin takes the place of infinity, as in Construct::hnorm,
+// hdist, hgen and hspin. Points are null vectors (5 coefficients) of any weight
+// inside the unit ball.
+//
+// Distances are evaluated as acosh(1 + 2 |a - b|^2 / ((1 - |a|^2)(1 - |b|^2)))
+// of the euclidean locations a and b, which is 1 - hnorm(a) . hnorm(b) without
+// the cancellation of the conformal inner product between close points.
+namespace hyperbolic {
+
+// Construct::hnorm of the `n` points in p.
+void normalize(std::size_t n, const double *p, double *out);
+
+// Construct::hdist of the points a and b, with increments a_inc and b_inc
+// (0 or 5).
+void distance(std::size_t n, const double *a, std::size_t a_inc,
+              const double *b, std::size_t b_inc, double *out);
+
+// Distances between each of the `n` points in a and each of the `m` points in
+// b, as the rows of the n by m matrix out. The matrix is filled in tiles, so a
+// tile of b stays in cache while it is paired with a block of rows.
+void distances(std::size_t n, const double *a, std::size_t m, const double *b,
+               double *out);
+
+// Construct::hgen of the points a and b and amounts t (one double each), as
+// point pairs (10 coefficients), with increments a_inc, b_inc (0 or 5) and
+// t_inc (0 or 1).
+void generator(std::size_t n, const double *a, std::size_t a_inc,
+               const double *b, std::size_t b_inc, const double *t,
+               std::size_t t_inc, double *out);
+
+// Construct::hspin of the points a towards b by the amounts t, the normalized
+// points (5 coefficients) at the fractions t of the geodesics from a to b.
+void spin(std::size_t n, const double *a, std::size_t a_inc, const double *b,
+          std::size_t b_inc, const double *t, std::size_t t_inc, double *out);
+
+// The `k` nearest of the `n` points in p to each of the `m` points in q, by
+// increasing distance, as the rows of the m by k matrices index and distance.
+// If `self`, q is p and each point is left out of its own neighbours. k must
+// be at most n, or n - 1 if `self`.
+//
+// The points are held in a kd tree over their euclidean locations. A box of the
+// tree is at least acosh(1 + 2 e^2 / ((1 - |a|^2)(1 - r^2))) away from a
+// point a, with e the euclidean distance from a to the box and r that from the
+// origin, so boxes are visited nearest first and left once the bound reaches
+// the k-th distance found, which keeps the search local near the boundary of
+// the ball where the euclidean scale shrinks.
+void neighbours(std::size_t m, const double *q, std::size_t n,
+                const double *p, std::size_t k, bool self,
+                std::int64_t *index, double *distance);
+
+} // namespace hyperbolic
+
+} // namespace c3d
+
+} // namespace pyversor
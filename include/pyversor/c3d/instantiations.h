@@ -0,0 +1,158 @@
+// Copyright (c) 2015, Lars Tingelstad
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of pyversor nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <versor/space/cga3D_op.h>
+#include <versor/space/cga3D_round.h>
+#include <versor/space/cga3D_types.h>
+
+// The products, sandwiches and casts between the named cga types that are
+// compiled into the pyversor library. Including this header makes them
+// explicit instantiation declarations, so translation units that link the
+// library call the library's optimized copy instead of instantiating their
+// own. Combinations that are not listed are instantiated as usual.
+//
+// The lists are X-macros: X(A, B) for the products and casts, and X(A, V) for
+// A.spin(V).
+
+#define PYVERSOR_C3D_GEOMETRIC_PRODUCTS(X)                                     \
+  X(Mot, Mot)                                                                  \
+  X(Mot, Trs)                                                                  \
+  X(Trs, Mot)                                                                  \
+  X(Mot, Rot)                                                                  \
+  X(Rot, Mot)                                                                  \
+  X(Mot, Dll)                                                                  \
+  X(Dll, Mot)                                                                  \
+  X(Trs, Rot)                                                                  \
+  X(Rot, Trs)                                                                  \
+  X(Trs, Trs)                                                                  \
+  X(Rot, Rot)                                                                  \
+  X(Bst, Bst)                                                                  \
+  X(Con, Con)                                                                  \
+  X(Pnt, Pnt)
+
+#define PYVERSOR_C3D_OUTER_PRODUCTS(X)                                         \
+  X(Pnt, Pnt)                                                                  \
+  X(Par, Pnt)                                                                  \
+  X(Cir, Pnt)                                                                  \
+  X(Pnt, Inf)                                                                  \
+  X(Par, Inf)                                                                  \
+  X(Cir, Inf)
+
+#define PYVERSOR_C3D_INNER_PRODUCTS(X)                                         \
+  X(Pnt, Pnt)                                                                  \
+  X(Pnt, Par)                                                                  \
+  X(Pnt, Cir)                                                                  \
+  X(Pnt, Sph)                                                                  \
+  X(Dll, Dll)
+
+#define PYVERSOR_C3D_SPINS(X)                                                  \
+  X(Pnt, Mot)                                                                  \
+  X(Par, Mot)                                                                  \
+  X(Cir, Mot)                                                                  \
+  X(Sph, Mot)                                                                  \
+  X(Flp, Mot)                                                                  \
+  X(Dll, Mot)                                                                  \
+  X(Lin, Mot)                                                                  \
+  X(Dlp, Mot)                                                                  \
+  X(Pln, Mot)                                                                  \
+  X(Drv, Mot)                                                                  \
+  X(Mot, Mot)                                                                  \
+  X(Pnt, Rot)                                                                  \
+  X(Biv, Rot)                                                                  \
+  X(Drv, Rot)                                                                  \
+  X(Pnt, Trs)                                                                  \
+  X(Par, Trs)                                                                  \
+  X(Cir, Trs)                                                                  \
+  X(Sph, Trs)                                                                  \
+  X(Dll, Trs)                                                                  \
+  X(Lin, Trs)                                                                  \
+  X(Dlp, Trs)                                                                  \
+  X(Pln, Trs)                                                                  \
+  X(Pnt, Bst)                                                                  \
+  X(Par, Bst)                                                                  \
+  X(Cir, Bst)                                                                  \
+  X(Sph, Bst)                                                                  \
+  X(Pnt, Con)                                                                  \
+  X(Par, Con)                                                                  \
+  X(Cir, Con)                                                                  \
+  X(Sph, Con)
+
+#define PYVERSOR_C3D_CASTS(X)                                                  \
+  X(Rot, Mot)                                                                  \
+  X(Trs, Mot)                                                                  \
+  X(Dll, Mot)                                                                  \
+  X(Biv, Dll)                                                                  \
+  X(Drv, Dll)                                                                  \
+  X(Mot, Rot)                                                                  \
+  X(Mot, Trs)                                                                  \
+  X(Mot, Dll)                                                                  \
+  X(Rot, Con)                                                                  \
+  X(Trs, Con)                                                                  \
+  X(Bst, Con)                                                                  \
+  X(Mot, Con)
+
+#define PYVERSOR_C3D_GEOMETRIC_PRODUCT(A, B)                                   \
+  template auto vsr::cga::A::operator*(                                        \
+      const vsr::cga::A::MultivectorB<vsr::cga::B::basis> &) const;
+#define PYVERSOR_C3D_OUTER_PRODUCT(A, B)                                       \
+  template auto vsr::cga::A::operator^(                                        \
+      const vsr::cga::A::MultivectorB<vsr::cga::B::basis> &) const;
+#define PYVERSOR_C3D_INNER_PRODUCT(A, B)                                       \
+  template auto vsr::cga::A::operator<=(                                       \
+      const vsr::cga::A::MultivectorB<vsr::cga::B::basis> &) const;
+#define PYVERSOR_C3D_SPIN(A, V)                                                \
+  template vsr::cga::A vsr::cga::A::spin(                                      \
+      const vsr::cga::A::MultivectorB<vsr::cga::V::basis> &) const;
+#define PYVERSOR_C3D_CAST(A, B)                                                \
+  template vsr::cga::B vsr::cga::A::cast<vsr::cga::B>() const;
+
+// Expands to the explicit instantiation definitions in the library.
+#define PYVERSOR_C3D_INSTANTIATE()                                             \
+  PYVERSOR_C3D_GEOMETRIC_PRODUCTS(PYVERSOR_C3D_GEOMETRIC_PRODUCT)              \
+  PYVERSOR_C3D_OUTER_PRODUCTS(PYVERSOR_C3D_OUTER_PRODUCT)                      \
+  PYVERSOR_C3D_INNER_PRODUCTS(PYVERSOR_C3D_INNER_PRODUCT)                      \
+  PYVERSOR_C3D_SPINS(PYVERSOR_C3D_SPIN)                                        \
+  PYVERSOR_C3D_CASTS(PYVERSOR_C3D_CAST)
+
+#define PYVERSOR_C3D_EXTERN_GEOMETRIC_PRODUCT(A, B)                            \
+  extern PYVERSOR_C3D_GEOMETRIC_PRODUCT(A, B)
+#define PYVERSOR_C3D_EXTERN_OUTER_PRODUCT(A, B)                                \
+  extern PYVERSOR_C3D_OUTER_PRODUCT(A, B)
+#define PYVERSOR_C3D_EXTERN_INNER_PRODUCT(A, B)                                \
+  extern PYVERSOR_C3D_INNER_PRODUCT(A, B)
+#define PYVERSOR_C3D_EXTERN_SPIN(A, V) extern PYVERSOR_C3D_SPIN(A, V)
+#define PYVERSOR_C3D_EXTERN_CAST(A, B) extern PYVERSOR_C3D_CAST(A, B)
+
+PYVERSOR_C3D_GEOMETRIC_PRODUCTS(PYVERSOR_C3D_EXTERN_GEOMETRIC_PRODUCT)
+PYVERSOR_C3D_OUTER_PRODUCTS(PYVERSOR_C3D_EXTERN_OUTER_PRODUCT)
+PYVERSOR_C3D_INNER_PRODUCTS(PYVERSOR_C3D_EXTERN_INNER_PRODUCT)
+PYVERSOR_C3D_SPINS(PYVERSOR_C3D_EXTERN_SPIN)
+PYVERSOR_C3D_CASTS(PYVERSOR_C3D_EXTERN_CAST)
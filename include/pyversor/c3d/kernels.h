@@ -0,0 +1,157 @@
+// Copyright (c) 2015, Lars Tingelstad
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of pyversor nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace pyversor {
+
+namespace c3d {
+
+// Batched kernels over contiguous arrays of multivector coefficients. Each
+// element is stored with the coefficients of the corresponding named type in
+// the same order as `toarray()`: 3 for e3d vectors, 5 for point_t, 6 for
+// dual_line_t and 8 for motor_t. An `*_inc` argument is the distance in
+// doubles between consecutive elements of that input; 0 broadcasts a single
+// element over the batch.
+//
+// Every kernel is compiled once per instruction set, and the fastest variant
+// supported by the CPU is selected the first time the table is requested. The
+// PYVERSOR_ISA environment variable (baseline, avx2 or avx512) overrides the
+// selection.
+namespace kernels {
+
+struct table {
+  const char *isa;
+  // Round::null of euclidean vectors.
+  void (*null)(std::size_t n, const double *x, double *out);
+  // Scale rounds so that their origin coefficient is one.
+  void (*normalize)(std::size_t n, const double *p, double *out);
+  // Gen::mot of dual lines, with a series instead of its small-angle cut-off.
+  void (*motor_exp)(std::size_t n, const double *dll, double *out);
+  // Gen::log of motors.
+  void (*motor_log)(std::size_t n, const double *mot, double *out);
+  // Geometric product of motors.
+  void (*motor_product)(std::size_t n, const double *a, std::size_t a_inc,
+                        const double *b, std::size_t b_inc, double *out);
+  // Spin of conformal vectors (points, dual spheres) by motors, m p ~m.
+  void (*motor_spin)(std::size_t n, const double *p, std::size_t p_inc,
+                     const double *m, std::size_t m_inc, double *out);
+  // Adds the weighted moments of the points x - origin (3 coefficients) with
+  // conformal coordinates X = (x, 1, x^2 / 2) to out: the sums of w, w x,
+  // w x x^T (xx, xy, xz, yy, yz, zz), w x^2 / 2, w x^2 / 2 x and w x^4 / 4,
+  // 15 in all. Null weights count as ones.
+  void (*moments)(std::size_t n, const double *x, const double *w,
+                  const double *origin, double *out);
+  // Number of the points with coordinates x, y, z and q = x^2 / 2, one array
+  // each, that lie within the threshold of a ransac hypothesis, and whether
+  // each one does in mask if it is not null. The parameters of each
+  // ransac::model are
+  //   sphere: c (3), d, r^2, lo^2, hi^2 for the normalized dual sphere
+  //           (c, 1, d), an inlier when lo^2 <= r^2 - 2 X . s <= hi^2
+  //   plane:  n (3), d, t for the unit dual plane (n, d), |X . p| <= t
+  //   circle: the sphere parameters up to r^2, followed by the unit dual
+  //           plane n (3), d of its carrier, an unused slot and t^2
+  //   line:   a point p (3), a unit direction u (3) and t^2.
+  std::size_t (*inliers)(int model, std::size_t n, const double *x,
+                         const double *y, const double *z, const double *q,
+                         const double *params, bool *mask);
+  // Adds the weighted cross moments of pairs of euclidean vectors a and b
+  // (3 coefficients each, `*_inc` apart) to out: the sums of w, w a, w b and
+  // w a b^T (row major), 16 in all. Null weights count as ones.
+  void (*cross_moments)(std::size_t n, const double *a, std::size_t a_inc,
+                        const double *b, std::size_t b_inc, const double *w,
+                        double *out);
+  // Number of the normalized dual spheres (x, 1, q) of radius r, with one
+  // array per coefficient, that touch or overlap the sphere (c, 1, d) of
+  // radius s, with c (3), d and s in params, and whether each one does in
+  // hit. Two spheres overlap when X . S >= -r s.
+  std::size_t (*overlaps)(std::size_t n, const double *x, const double *y,
+                          const double *z, const double *q, const double *r,
+                          const double *params, bool *hit);
+  // Gen::normalize of motors.
+  void (*motor_normalize)(std::size_t n, const double *m, double *out);
+  // Rotation matrices of rotors (m_inc 4) or motors (m_inc 8), as 3 rows of
+  // `row` doubles (3 or 4), row major and `out_inc` apart. With rows of 4 the
+  // fourth column holds the translation of motors, or zeros for rotors.
+  void (*motor_matrix)(std::size_t n, const double *m, std::size_t m_inc,
+                       std::size_t row, double *out, std::size_t out_inc);
+  // Unit rotors (out_inc 4) or motors (out_inc 8) of the matrices x, in the
+  // layout of motor_matrix, by Shepperd's method. Motors take the
+  // translation from the fourth column if row is 4 and are pure rotations
+  // otherwise.
+  void (*matrix_motor)(std::size_t n, const double *x, std::size_t x_inc,
+                       std::size_t row, double *out, std::size_t out_inc);
+  // Gen::bst of point pairs (10 coefficients), as boost_t (11).
+  void (*boost)(std::size_t n, const double *p, double *out);
+  // Spin of conformal vectors by the boosts Gen::bst(p) of point pairs p,
+  // without forming the boosts.
+  void (*boost_spin)(std::size_t n, const double *x, std::size_t x_inc,
+                     const double *p, std::size_t p_inc, double *out);
+  // Gen::dil(p, t) of points p and amounts t (one double each), as the 5
+  // coefficients of the translated dilator.
+  void (*dilator)(std::size_t n, const double *p, std::size_t p_inc,
+                  const double *t, std::size_t t_inc, double *out);
+  // Spin of conformal vectors x by Gen::dil(p, t), without forming the
+  // dilators.
+  void (*dilate)(std::size_t n, const double *x, std::size_t x_inc,
+                 const double *p, std::size_t p_inc, const double *t,
+                 std::size_t t_inc, double *out);
+  // Lowers value[i] to the field of one primitive at the points with
+  // coordinates x, y, z, one array each, and sets index[i] to `id` where it
+  // does. The parameters of each field::model are
+  //   sphere: c (3) and r for |x - c| - r, or (|x - c|^2 - r^2) / 2 if inner
+  //   plane:  a unit normal n (3) and d for d - x . n
+  //   line:   a point p (3) and a unit direction u (3) for the distance
+  //           from the line, or half its square if inner.
+  void (*field)(int model, bool inner, std::size_t n, const double *x,
+                const double *y, const double *z, const double *params,
+                std::int64_t id, double *value, std::int64_t *index);
+};
+
+// The kernels of the selected instruction set.
+const table &get();
+
+// Instruction sets compiled into the module and supported by this CPU,
+// from slowest to fastest.
+std::vector<std::string> available();
+
+// Select the kernels of instruction set `isa`. Throws std::invalid_argument
+// if it is not available.
+void select(const std::string &isa);
+
+} // namespace kernels
+
+} // namespace c3d
+
+} // namespace pyversor
@@ -0,0 +1,132 @@
+// Copyright (c) 2015, Lars Tingelstad
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of pyversor nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace pyversor {
+
+namespace c3d {
+
+// The linear maps x -> V x ~V of a versor V on each grade of the conformal
+// algebra, as matrices over the blades of that grade in ascending order of
+// their bitmasks (e1, e2, e3, no, ni are the bits 1 to 16), which is the
+// order of the coefficients of every named type. The map of a blade
+// a1 ^ ... ^ ak is s^(1 - k) (V a1 ~V) ^ ... ^ (V ak ~V) with s = V ~V, so
+// grade k holds the k-th compound matrix of the map on vectors, whose entries
+// are its k by k minors.
+class outermorphism {
+public:
+  // Relative size of the parts of V ~V other than its scalar, against the
+  // squared norm of the coefficients of V, beyond which V is not a versor.
+  static constexpr double tolerance = 1e-9;
+
+  // From the images of e1, e2, e3, no and ni, which are the columns of the
+  // 5 by 5 row major matrix `vectors`, and the scalar s = V ~V.
+  outermorphism(const double *vectors, double s);
+
+  // Of the versor v. Throws std::invalid_argument if V ~V is not a scalar,
+  // since the maps of the higher grades are then not those of `spin`.
+  template <typename V> static outermorphism of(const V &v) {
+    using vector = typename V::algebra::template make_grade<1>;
+    const auto vv = v * ~v;
+    const auto vv_blades = blades<typename std::decay<decltype(vv)>::type>();
+    double s = 0.0;
+    double rest = 0.0;
+    for (std::size_t i = 0; i < vv_blades.size(); ++i) {
+      if (vv_blades[i] == 0) {
+        s = vv[i];
+      } else {
+        rest = std::max(rest, std::abs(vv[i]));
+      }
+    }
+    double norm = 0.0;
+    for (const auto c : v.val) {
+      norm += c * c;
+    }
+    if (rest > tolerance * norm) {
+      throw std::invalid_argument("V ~V must be a scalar, V is not a versor");
+    }
+    double m[25];
+    for (int j = 0; j < 5; ++j) {
+      vector e;
+      e[j] = 1.0;
+      auto x = vector(e.spin(v));
+      for (int i = 0; i < 5; ++i) {
+        m[5 * i + j] = x[i];
+      }
+    }
+    return outermorphism(m, s);
+  }
+
+  // Bitmasks of the blades of the named type T, in the order of its
+  // coefficients.
+  template <typename T> static std::vector<int> blades() {
+    std::vector<int> out;
+    add_blades(typename T::basis(), out);
+    return out;
+  }
+
+  // Number of blades of grade k, and the row major matrix of that grade.
+  static std::size_t dimension(int k);
+  const double *grade(int k) const { return grades_[k].data(); }
+
+  // Row major matrix on the coefficients of a type with the given blades.
+  // Images outside the span of those blades are dropped, as by `spin`.
+  std::vector<double> block(const std::vector<int> &blades) const;
+
+  // Maps n elements of a type with the given blades.
+  void apply(std::size_t n, const double *x, const std::vector<int> &blades,
+             double *out) const;
+
+private:
+  template <typename B> static void add_blades(B, std::vector<int> &out) {
+    add_blades<B>(out, std::integral_constant<bool, B::Num == 0>());
+  }
+  template <typename B>
+  static void add_blades(std::vector<int> &, std::true_type) {}
+  template <typename B>
+  static void add_blades(std::vector<int> &out, std::false_type) {
+    out.push_back(B::HEAD);
+    add_blades(typename B::TAIL(), out);
+  }
+
+  std::array<std::vector<double>, 6> grades_;
+};
+
+} // namespace c3d
+
+} // namespace pyversor
@@ -0,0 +1,86 @@
+// Copyright (c) 2015, Lars Tingelstad
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of pyversor nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace pyversor {
+
+namespace c3d {
+
+// Detection of a sphere, plane, circle or line in a point cloud by random
+// sample consensus. Hypotheses come from minimal samples through
+// Construct::sphere, Construct::plane, Construct::circle and Construct::line,
+// and are scored by the number of points within the threshold, using the
+// inner product of the null points with the dual sphere and dual plane of the
+// hypothesis.
+//
+// Hypotheses are drawn in rounds spread over the worker threads, each from its
+// own random stream derived from the seed and its index, so the result only
+// depends on the seed. The search stops once the best hypothesis so far makes
+// more draws unnecessary at the requested confidence, or after the maximum
+// number of hypotheses.
+namespace ransac {
+
+enum class model { sphere, plane, circle, line };
+
+// Points in a minimal sample, and coefficients of the detected element: a
+// normalized dual sphere (5), a unit dual plane (4), a direct circle (10) or
+// a unit direct line (6).
+std::size_t sample_size(model m);
+std::size_t model_size(model m);
+
+struct options {
+  // Largest distance of an inlier to the model.
+  double threshold = 0.01;
+  // Probability of having drawn at least one sample of inliers on stopping.
+  double confidence = 0.99;
+  std::size_t max_iterations = 10000;
+  std::uint64_t seed = 0;
+};
+
+struct result {
+  std::size_t inliers;
+  std::size_t iterations;
+};
+
+// Best model of the `n` euclidean points in x (3 coefficients), written to
+// out, and whether each point is an inlier of it in mask, if not null. If
+// every sample is degenerate, out is NaN and there are no inliers. Throws
+// std::invalid_argument if there are fewer points than a sample needs.
+result detect(model m, std::size_t n, const double *x, const options &opts,
+              double *out, bool *mask);
+
+} // namespace ransac
+
+} // namespace c3d
+
+} // namespace pyversor
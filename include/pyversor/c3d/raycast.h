@@ -0,0 +1,74 @@
+// Copyright (c) 2015, Lars Tingelstad
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of pyversor nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace pyversor {
+
+namespace c3d {
+
+// Intersections of many lines with many dual spheres and dual planes, tiled
+// over lines and targets and spread over num_threads() threads. Lines are
+// passed as dual_line_t (6 coefficients) and targets as conformal vectors (5
+// coefficients), which are dual spheres, or dual planes when their origin
+// coefficient is zero.
+namespace raycast {
+
+// Dual lines of `m` lines.
+void dual_lines(std::size_t m, const double *lin, double *dll);
+
+// Construct::meet of each of the `m` dual lines with each of the `n` targets,
+// an (m, n, 10) array of point pairs. A line meets a dual plane in a flat
+// point.
+void meet(std::size_t m, const double *dll, std::size_t n, const double *s,
+          double *out);
+
+// Round::split of `n` point pairs into an (n, 2, 5) array of normalized
+// points. real[i] is false if the pair is imaginary, that is if the line
+// misses the target, and both points are then the center of the pair. Both
+// points of a flat point are its location.
+void split(std::size_t n, const double *pp, double *points, bool *real);
+
+// First target hit by each of the `m` rays. Ray i starts at origin[i] (3
+// coefficients) and runs along the direction of line i; if `origin` is null it
+// starts at the point of the line closest to the origin. index[i] is the
+// target hit first, or -1 if there is none, and distance[i] the distance to
+// it, or infinity.
+void nearest(std::size_t m, const double *dll, const double *origin,
+             std::size_t n, const double *s, std::int64_t *index,
+             double *distance);
+
+} // namespace raycast
+
+} // namespace c3d
+
+} // namespace pyversor
@@ -0,0 +1,67 @@
+// Copyright (c) 2015, Lars Tingelstad
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of pyversor nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <cstddef>
+
+namespace pyversor {
+
+namespace c3d {
+
+// Estimation of the motor that best aligns corresponding points, lines or
+// planes, for many independent problems at once.
+//
+// For these elements the least squares problem over the 8 motor coefficients
+// separates: the rotor is the dominant eigenvector of the 4 x 4 matrix of the
+// weighted cross moments of the directions (the point offsets from their
+// centroid, the line directions or the plane normals), and the translation
+// then solves a 3 x 3 linear system (the centroid offset, the line moments or
+// the plane offsets). Directions that leave the translation undetermined,
+// parallel lines or planes, give its least norm solution.
+namespace registration {
+
+enum class kind { points, lines, planes };
+
+// Coefficients of each element: euclidean points (3), dual lines (6) and dual
+// planes (4).
+std::size_t width(kind k);
+
+// Motors m (8 coefficients) of `problems` problems of `n` correspondences
+// each, such that spinning the elements of a by m approximates those of b,
+// with the weights in w, or ones if w is null. Each problem takes n
+// consecutive elements of a, b and w.
+void motors(kind k, std::size_t problems, std::size_t n, const double *a,
+            const double *b, const double *w, double *out);
+
+} // namespace registration
+
+} // namespace c3d
+
+} // namespace pyversor
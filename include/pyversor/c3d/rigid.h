@@ -0,0 +1,88 @@
+// Copyright (c) 2015, Lars Tingelstad
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of pyversor nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace pyversor {
+
+namespace c3d {
+
+// Rigid bodies with motor poses M and spatial twists V, advanced by Lie group
+// integrators in which the poses move by exponentials of scaled twists,
+// M <- Gen::mot(h V) M, so they stay motors up to round-off.
+//
+// Twists follow the convention of the chain Jacobian and the spline
+// velocities: M(t + dt) = Gen::mot(V dt) M(t) to first order. Each body is
+// torque free about its origin, which is its center of mass, with its
+// principal axes along the axes of its frame, and falls under a common
+// gravity. Its twist changes through the gyroscopic terms of the Euler
+// equations and through gravity.
+class rigid_bodies {
+public:
+  enum class method { euler, crouch_grossman, rk4 };
+
+  struct options {
+    // Acceleration of gravity (3 coefficients).
+    double gravity[3] = {0.0, 0.0, 0.0};
+    // Steps between normalizations of the poses by Gen::normalize, or 0 for
+    // never.
+    std::size_t renormalize = 16;
+  };
+
+  // `n` bodies with the poses in motors (8 coefficients each), the twists in
+  // twists (6) and the principal moments of inertia in inertia (3), or
+  // isotropic ones if it is null.
+  rigid_bodies(std::size_t n, const double *motors, const double *twists,
+               const double *inertia = nullptr);
+
+  std::size_t size() const { return twists_.size() / 6; }
+  const double *motors() const { return motors_.data(); }
+  const double *twists() const { return twists_.data(); }
+  const double *inertia() const { return inertia_.data(); }
+
+  // Advances every body by `steps` steps of length h with method m: the Lie
+  // Euler method (order 1), the Crouch-Grossman method of order 3 or the
+  // commutator free Runge-Kutta method of order 4 of Celledoni, Marthinsen
+  // and Owren.
+  void step(double h, std::size_t steps, method m, const options &opts);
+
+private:
+  std::vector<double> motors_;
+  std::vector<double> twists_;
+  std::vector<double> inertia_;
+  // Steps since the last renormalization.
+  std::size_t since_ = 0;
+};
+
+} // namespace c3d
+
+} // namespace pyversor
@@ -0,0 +1,62 @@
+// Copyright (c) 2015, Lars Tingelstad
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of pyversor nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <cstddef>
+
+namespace pyversor {
+
+namespace c3d {
+
+// Sampling of points on circles and spheres. The frame of each element is
+// taken once, and the samples are its center plus the radius times the
+// cosines and sines of the angles, which are shared by all elements, along
+// the axes of the frame. Samples are written as null points (5 coefficients).
+namespace sampling {
+
+// Points at the `m` angles t on each of the `n` direct circles in cir (10
+// coefficients), n x m in out: Construct::point(c, t), with the axes of the
+// frame through its points at angles 0 and pi / 2.
+void circle_points(std::size_t n, const double *cir, std::size_t m,
+                   const double *t, double *out);
+
+// Points on each of the `n` dual spheres in dls (5 coefficients) at the grid
+// of the `mu` angles theta around the y axis and the `mv` elevations phi,
+// n x mu x mv in out: pointOnSphere(s, theta, phi), in the direction
+// (cos phi cos theta, -sin phi, -cos phi sin theta) from the center.
+void sphere_points(std::size_t n, const double *dls, std::size_t mu,
+                   const double *theta, std::size_t mv, const double *phi,
+                   double *out);
+
+} // namespace sampling
+
+} // namespace c3d
+
+} // namespace pyversor
@@ -0,0 +1,81 @@
+// Copyright (c) 2015, Lars Tingelstad
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of pyversor nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace pyversor {
+
+namespace c3d {
+
+// Motor trajectory through keyframes at increasing times, interpolated in the
+// dual line log space of the relative motors D_k = M_{k+1} ~M_k, which are
+// taken once on construction.
+//
+// A linear spline follows the geodesic between neighbouring keyframes,
+// Gen::ratio(M_k, M_{k+1}, s) M_k. A B-spline is the cumulative cubic
+// B-spline over the keyframes, with the first and last repeated so that it
+// spans the same times; it is C2 in the segment parameter, and so in time for
+// evenly spaced keyframes, but does not pass through the keyframes.
+//
+// Velocities and accelerations are dual lines in the convention of the chain
+// Jacobian: M(t + dt) = Gen::mot(V dt) M(t) to first order.
+class spline {
+public:
+  enum class kind { linear, bspline };
+
+  // Spline of kind k through `n` keyframe motors (8 coefficients each) at
+  // strictly increasing times. Throws std::invalid_argument if there are no
+  // keyframes or the times are not increasing.
+  spline(kind k, std::size_t n, const double *motors, const double *times);
+
+  kind type() const { return kind_; }
+  std::size_t size() const { return times_.size(); }
+
+  // Motors and, if not null, velocities and accelerations at the `m` times
+  // in t, which are clamped to the times of the first and last keyframes;
+  // the derivatives are zero outside them.
+  void evaluate(std::size_t m, const double *t, double *motors,
+                double *velocity, double *acceleration) const;
+
+private:
+  kind kind_;
+  std::vector<double> times_;
+  // Keyframes, flipped to the sign that gives the shortest relative motors,
+  // with the first and last repeated for B-splines.
+  std::vector<double> motors_;
+  // Logs of the relative motors between consecutive entries of motors_.
+  std::vector<double> logs_;
+};
+
+} // namespace c3d
+
+} // namespace pyversor
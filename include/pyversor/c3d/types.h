@@ -39,6 +39,8 @@
 #include <versor/space/cga3D_round.h>
 #include <versor/space/cga3D_types.h>
 
+#include <pyversor/c3d/instantiations.h>
+
 namespace pyversor {
 
 namespace py = pybind11;
@@ -74,6 +76,7 @@ using motor_t = vsr::cga::Mot;
 using translator_t = vsr::cga::Trs;
 using conformal_rotor_t = vsr::cga::Con;
 using boost_t = vsr::cga::Bst;
+using dilator_t = vsr::cga::Tsd;
 using dual_line_t = vsr::cga::Dll;
 using line_t = vsr::cga::Lin;
 using dual_plane_t = vsr::cga::Dlp;
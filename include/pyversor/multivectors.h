@@ -51,6 +51,14 @@ template <typename T> static constexpr auto estrings() {
   return earr;
 }
 
+// Overload of the unary method `name` that writes its result into a
+// preallocated `out` and returns `out`.
+template <typename T, typename R>
+void def_unary_out(py::class_<T> &t, const char *name, R (T::*f)() const) {
+  t.def(name, [f](const T &arg, R &out) -> R & { return out = (arg.*f)(); },
+        py::arg("out"));
+}
+
 template <typename T>
 py::class_<T> def_multivector(py::module &m, const std::string &name) {
   auto t =
@@ -77,20 +85,27 @@ py::class_<T> def_multivector(py::module &m, const std::string &name) {
   t.def("conjugate", &T::conjugation);
   // Conformal dual
   t.def("dual", &T::dual);
+  def_unary_out(t, "dual", &T::dual);
   // Conformal undual
   t.def("undual", &T::undual);
+  def_unary_out(t, "undual", &T::undual);
   // Euclidean dual
   t.def("duale", &T::duale);
+  def_unary_out(t, "duale", &T::duale);
   // Euclidean undual
   t.def("unduale", &T::unduale);
+  def_unary_out(t, "unduale", &T::unduale);
   // Weights, units and norms
   t.def("weight", &T::wt);
   t.def("rweight", &T::rwt);
   t.def("norm", &T::norm);
   t.def("rnorm", &T::rnorm);
   t.def("unit", &T::unit);
+  def_unary_out(t, "unit", &T::unit);
   t.def("runit", &T::runit);
+  def_unary_out(t, "runit", &T::runit);
   t.def("tunit", &T::tunit);
+  def_unary_out(t, "tunit", &T::tunit);
   // Grade projection operator
   // t.def("grade", [](const T &arg, int grade) {
   //   switch (grade) {
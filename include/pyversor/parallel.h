@@ -0,0 +1,90 @@
+// Copyright (c) 2015, Lars Tingelstad
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of pyversor nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+namespace pyversor {
+
+// Number of worker threads used by the batched operations, taken from the
+// PYVERSOR_NUM_THREADS environment variable or the number of hardware threads.
+inline std::size_t num_threads() {
+  static const std::size_t n = []() -> std::size_t {
+    if (auto env = std::getenv("PYVERSOR_NUM_THREADS")) {
+      auto v = std::atoi(env);
+      if (v > 0) {
+        return static_cast<std::size_t>(v);
+      }
+    }
+    auto hw = std::thread::hardware_concurrency();
+    return hw > 0 ? hw : 1;
+  }();
+  return n;
+}
+
+// Calls f(begin, end) on consecutive chunks of at most `grain` indices that
+// together cover [0, n). Chunks are handed out to the worker threads as they
+// become free, the calling thread takes part and the call returns when every
+// chunk is done. `f` must not throw.
+template <typename F>
+void parallel_for(std::size_t n, std::size_t grain, F f) {
+  grain = std::max<std::size_t>(grain, 1);
+  auto chunks = (n + grain - 1) / grain;
+  auto workers = std::min(num_threads(), chunks);
+  if (workers <= 1) {
+    for (std::size_t begin = 0; begin < n; begin += grain) {
+      f(begin, std::min(begin + grain, n));
+    }
+    return;
+  }
+  std::atomic<std::size_t> next(0);
+  auto work = [&]() {
+    for (auto c = next++; c < chunks; c = next++) {
+      auto begin = c * grain;
+      f(begin, std::min(begin + grain, n));
+    }
+  };
+  std::vector<std::thread> threads;
+  threads.reserve(workers - 1);
+  for (std::size_t i = 1; i < workers; ++i) {
+    threads.emplace_back(work);
+  }
+  work();
+  for (auto &t : threads) {
+    t.join();
+  }
+}
+
+} // namespace pyversor
@@ -32,16 +32,43 @@
 #include <pybind11/operators.h>
 #include <pybind11/pybind11.h>
 #include <type_traits>
+#include <utility>
+
+#include <versor/detail/xlists.h>
 
 namespace pyversor {
 
 namespace py = pybind11;
 
+// In-place operators and `out` overloads return a reference to an object that
+// is already owned by Python. pybind11 finds the registered instance and hands
+// back the same Python object instead of allocating a new one.
+
+// True if every blade of R is also a blade of A, i.e. assigning an R to an A
+// does not drop any coefficients.
+template <typename A, typename R>
+struct is_subspace
+    : std::integral_constant<
+          bool, vsr::NotType<typename A::basis, typename R::basis>::Type::Num ==
+                    0> {};
+
+template <typename A, typename B>
+using geometric_product_t =
+    decltype(std::declval<const A &>() * std::declval<const B &>());
+
+template <typename A, typename B>
+using outer_product_t =
+    decltype(std::declval<const A &>() ^ std::declval<const B &>());
+
+template <typename A, typename B>
+using inner_product_t =
+    decltype(std::declval<const A &>() <= std::declval<const B &>());
+
 template <typename A, typename B, typename module_t>
 auto def_addition(module_t &m) {
   m.def("__add__", [](const A &lhs, const B &rhs) { return lhs + rhs; },
         py::is_operator());
-  m.def("__iadd__", [](A &lhs, const B &rhs) { return lhs += rhs; },
+  m.def("__iadd__", [](A &lhs, const B &rhs) -> A & { return lhs += rhs; },
         py::is_operator());
 }
 
@@ -52,19 +79,19 @@ template <typename A, typename module_t> auto def_scalar_addition(module_t &m) {
         py::is_operator());
 }
 
+// The sum is of a different type C than the receiver A, so there is no
+// `__iadd__` and Python rebinds `a += b` to the result of `__add__`.
 template <typename A, typename B, typename C, typename module_t>
 auto def_addition(module_t &m) {
   m.def("__add__", [](const A &lhs, const B &rhs) { return C(lhs + rhs); },
         py::is_operator());
-  m.def("__iadd__", [](A &lhs, const B &rhs) { return C(lhs += rhs); },
-        py::is_operator());
 }
 
 template <typename A, typename B, typename module_t>
 auto def_subtraction(module_t &m) {
   m.def("__sub__", [](const A &lhs, const B &rhs) { return lhs - rhs; },
         py::is_operator());
-  m.def("__sub__", [](A &lhs, const B &rhs) { return lhs -= rhs; },
+  m.def("__isub__", [](A &lhs, const B &rhs) -> A & { return lhs -= rhs; },
         py::is_operator());
 }
 
@@ -72,14 +99,18 @@ template <typename A, typename B, typename C, typename module_t>
 auto def_subtraction(module_t &m) {
   m.def("__sub__", [](const A &lhs, const B &rhs) { return C(lhs - rhs); },
         py::is_operator());
-  m.def("__isub__", [](A &lhs, const B &rhs) { return C(lhs -= rhs); },
-        py::is_operator());
 }
 
 template <typename A, typename B, typename module_t>
 auto def_outer_product(module_t &m) {
   m.def("__xor__", [](const A &lhs, const B &rhs) { return lhs ^ rhs; });
   m.def("outer", [](const A &lhs, const B &rhs) { return lhs ^ rhs; });
+  using C = outer_product_t<A, B>;
+  m.def("outer",
+        [](const A &lhs, const B &rhs, C &out) -> C & {
+          return out = lhs ^ rhs;
+        },
+        py::arg("rhs"), py::arg("out"));
 }
 
 template <typename A, typename B, typename module_t>
@@ -88,8 +119,25 @@ auto def_inner_product(module_t &m) {
         py::is_operator());
   m.def("inner", [](const A &lhs, const B &rhs) { return lhs <= rhs; },
         py::is_operator());
+  using C = inner_product_t<A, B>;
+  m.def("inner",
+        [](const A &lhs, const B &rhs, C &out) -> C & {
+          return out = lhs <= rhs;
+        },
+        py::arg("rhs"), py::arg("out"));
 }
 
+// `a *= b` only mutates `a` when the product lies in the span of A, otherwise
+// Python falls back to `__mul__`.
+template <typename A, typename B, typename module_t>
+void def_inplace_geometric_product(module_t &m, std::true_type) {
+  m.def("__imul__", [](A &lhs, const B &rhs) -> A & { return lhs *= rhs; },
+        py::is_operator());
+}
+
+template <typename A, typename B, typename module_t>
+void def_inplace_geometric_product(module_t &, std::false_type) {}
+
 template <typename A, typename B, typename module_t>
 auto def_geometric_product(module_t &m) {
   if (std::is_same<B, double>()) {
@@ -97,13 +145,20 @@ auto def_geometric_product(module_t &m) {
           py::is_operator());
     m.def("__rmul__", [](const A &lhs, double rhs) { return lhs * rhs; },
           py::is_operator());
-    m.def("__imul__", [](A &lhs, double rhs) { return lhs *= rhs; },
+    m.def("__imul__", [](A &lhs, double rhs) -> A & { return lhs *= rhs; },
           py::is_operator());
   } else {
+    using C = geometric_product_t<A, B>;
     m.def("geometric", [](const A &lhs, const B &rhs) { return lhs * rhs; },
           py::is_operator());
+    m.def("geometric",
+          [](const A &lhs, const B &rhs, C &out) -> C & {
+            return out = lhs * rhs;
+          },
+          py::arg("rhs"), py::arg("out"));
     m.def("__mul__", [](const A &lhs, const B &rhs) { return lhs * rhs; },
           py::is_operator());
+    def_inplace_geometric_product<A, B>(m, is_subspace<A, C>());
   }
 }
 
@@ -111,6 +166,11 @@ template <typename A, typename B, typename C, typename module_t>
 auto def_geometric_product(module_t &m) {
   m.def("geometric", [](const A &lhs, const B &rhs) { return C(lhs * rhs); },
         py::is_operator());
+  m.def("geometric",
+        [](const A &lhs, const B &rhs, C &out) -> C & {
+          return out = C(lhs * rhs);
+        },
+        py::arg("rhs"), py::arg("out"));
   m.def("__mul__", [](const A &lhs, const B &rhs) { return C(lhs * rhs); },
         py::is_operator());
 }
@@ -118,11 +178,21 @@ auto def_geometric_product(module_t &m) {
 template <typename A, typename B, typename module_t>
 auto def_sandwich_product(module_t &m) {
   m.def("spin", [](const A &lhs, const B &rhs) { return lhs.spin(rhs); });
+  m.def("spin",
+        [](const A &lhs, const B &rhs, A &out) -> A & {
+          return out = lhs.spin(rhs);
+        },
+        py::arg("rhs"), py::arg("out"));
 }
 
 template <typename A, typename B, typename C, typename module_t>
 auto def_sandwich_product(module_t &m) {
   m.def("spin", [](const A &lhs, const B &rhs) { return C(lhs).spin(rhs); });
+  m.def("spin",
+        [](const A &lhs, const B &rhs, C &out) -> C & {
+          return out = C(lhs).spin(rhs);
+        },
+        py::arg("rhs"), py::arg("out"));
 }
 
 } // namespace pyversor
\ No newline at end of file
@@ -40,13 +40,17 @@
 
 #include <pyversor/e3d/e3d.h>
 
+#include <pyversor/c3d/batch.h>
 #include <pyversor/c3d/construct.h>
 #include <pyversor/c3d/directions.h>
+#include <pyversor/c3d/fit.h>
 #include <pyversor/c3d/flats.h>
 #include <pyversor/c3d/generate.h>
+#include <pyversor/c3d/kinematics.h>
 #include <pyversor/c3d/multivectors.h>
 #include <pyversor/c3d/operate.h>
 #include <pyversor/c3d/rounds.h>
+#include <pyversor/c3d/spatial.h>
 #include <pyversor/c3d/tangents.h>
 #include <pyversor/c3d/types.h>
 #include <pyversor/c3d/versors.h>
@@ -82,4 +86,13 @@ void def_submodule(py::module &m);
 
 } // namespace c3d
 
+// Creates an empty submodule `name` whose classes and functions are only
+// registered by `def` the first time the submodule is loaded, either through
+// `load_submodule` or on first attribute access.
+void def_lazy_submodule(py::module &m, const std::string &name,
+                        void (*def)(py::module &));
+
+// Registers the body of the lazy submodule `name`. Loading an already loaded submodule is a no-op.
+void load_submodule(py::module &m, const std::string &name);
+
 } // namespace pyversor
\ No newline at end of file
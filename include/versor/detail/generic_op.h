@@ -32,6 +32,7 @@
 
 #include <versor/detail/multivector.h>
 #include <versor/util/util.h>
+#include <array>
 #include <vector>
 
 namespace vsr {
@@ -581,8 +582,7 @@ struct Round {
 
   // Split Points from Point Pair
   template <class A>
-  static std::vector<GAPnt<A>> split(const GAPar<A> &pp) {
-    std::vector<GAPnt<A>> pair;
+  static std::array<GAPnt<A>, 2> split(const GAPar<A> &pp) {
     VSR_PRECISION r = sqrt(fabs((pp <= pp)[0]));
     // dual line in 2d, dual plane in 3d
     auto d = GAInf<A>(-1) <= pp;
@@ -594,20 +594,16 @@ struct Round {
     bstA += GASca<A>(r);
     bstB -= GASca<A>(r);
 
-    GAPnt<A> pA;
-    pA = (bstA) / d;
-    GAPnt<A> pB;
-    pB = (bstB) / d;
-
-    pair.push_back(pA);
-    pair.push_back(pB);
+    std::array<GAPnt<A>, 2> pair;
+    pair[0] = (bstA) / d;
+    pair[1] = (bstB) / d;
 
     return pair;
   }
 
   // Split Points from Point Pair and normalize
   template <class A>
-  static std::vector<GAPnt<A>> splitLocation(const GAPar<A> &pp) {
+  static std::array<GAPnt<A>, 2> splitLocation(const GAPar<A> &pp) {
     auto tp = split(pp);
     for (auto &i : tp) i = location(i);
     return tp;
@@ -627,7 +623,7 @@ struct Round {
 
   // Split A Circle into its dual point pair poles
   template <class A>
-  static std::vector<GAPnt<A>> split(const GACir<A> &nc) {
+  static std::array<GAPnt<A>, 2> split(const GACir<A> &nc) {
     return split(nc.dual());
   }
 
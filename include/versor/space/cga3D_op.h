@@ -94,6 +94,19 @@ struct Op {
   }
 };
 
+/*! Commuting point pairs of a bivector split or of the split log of a
+    conformal rotor: at most two, stored in place */
+struct PairSplit {
+  Pair pairs[2];
+  int num = 0;
+
+  int size() const { return num; }
+  const Pair &operator[](int i) const { return pairs[i]; }
+  const Pair *begin() const { return pairs; }
+  const Pair *end() const { return pairs + num; }
+  void push_back(const Pair &p) { pairs[num++] = p; }
+};
+
 // Generators and Logarithms Optimized for 3D Conformal Geometric Algebra
 struct Gen {
 
@@ -164,6 +177,14 @@ struct Gen {
   */
   static Dll log(const Mot &m);
 
+  /*! Closest vsr::cga::Motor to a drifted one, m (m ~m)^-1/2
+      @param m a vsr::cga::Motor with m ~m = s + t e123inf, s > 0
+
+      Rescales the rotation and corrects the translation so that m ~m = 1,
+     which unit() and runit() leave off by the e123inf term
+  */
+  static Mot normalize(const Mot &m);
+
   /*! DualLine generator of Motor That Twists DualLine a to DualLine b by amt
      t;
 
@@ -253,32 +274,36 @@ struct Gen {
 
   /*! Bivector Split
         Takes a general bivector and splits  it into commuting pairs
-        will give sinh(B+-)
+        will give sinh(B+-); a single pair if it squares to zero, two NaN
+        pairs if it stays degenerate after a few perturbations
    */
-  static vector<Pair> split(const Pair &par);
+  static PairSplit split(const Pair &par);
 
   /*! Bivector Split
         Takes a general ROTOR and splits  it into commuting pairs
         will give sinh(B+-)
    */
-  static vector<Pair> split(const Con &con);
+  static PairSplit split(const Con &con);
 
-  /*! Split Log of General Conformal Rotor */
-  static vector<Pair> log(const Con &rot);
+  /*! Split Log of General Conformal Rotor, NaN pairs if the split fails */
+  static PairSplit log(const Con &rot);
 
   /*! Split Log from a ratio of two Circles */
-  static vector<Pair> log(const Circle &ca, const Circle &cb,
-                          bool bFlip = false, VSR_PRECISION theta = 0);
+  static PairSplit log(const Circle &ca, const Circle &cb, bool bFlip = false,
+                       VSR_PRECISION theta = 0);
 
   /*! Split Log from a ratio of two Circles */
-  static vector<Pair> log(const Pair &ca, const Pair &cb, bool bFlip = false,
-                          VSR_PRECISION theta = 0);
+  static PairSplit log(const Pair &ca, const Pair &cb, bool bFlip = false,
+                       VSR_PRECISION theta = 0);
 
   /*! General Conformal Transformation from a split log*/
+  static Con con(const PairSplit &log, VSR_PRECISION amt);
   static Con con(const vector<Pair> &log, VSR_PRECISION amt);
 
   /*! General Conformal Transformation from a split log and two amts (one for
    * each)*/
+  static Con con(const PairSplit &log, VSR_PRECISION amtA,
+                 VSR_PRECISION amtB);
   static Con con(const vector<Pair> &log, VSR_PRECISION amtA,
                  VSR_PRECISION amtB);
 
@@ -473,6 +498,11 @@ struct Construct {
   static Pair meet(const Cir &cir, const Dlp &dlp);
   /// point pair intersection of circle and Dual sphere
   static Pair meet(const Cir &cir, const Dls &s);
+  /// point pair intersection of line and Dual sphere (a flat point if the
+  /// dual sphere is a dual plane)
+  static Pair meet(const Line &lin, const Dls &s);
+  /// point pair intersection of dual line and Dual sphere
+  static Pair meet(const DualLine &dll, const Dls &s);
 
 #pragma mark HIT_TESTS
 
@@ -537,11 +567,16 @@ const auto pointOnLine = [](const Line &lin, const Point &v) {
 const auto pointOnCircle = [](const Circle &c, VSR_PRECISION t) {
   return Construct::point(c, t);
 };
-/// n points on circle c
+/// n points on circle c, along the frame through its points at 0 and pi/2
 const auto pointsOnCircle = [](const Circle &c, int num) {
+  auto o = Vec(Round::location(c));
+  auto a = Vec(Round::location(pointOnCircle(c, 0))) - o;
+  auto b = Vec(Round::location(pointOnCircle(c, PIOVERTWO))) - o;
   vector<Point> out;
+  out.reserve(num + 1);
   for (int i = 0; i <= num; ++i) {
-    out.push_back(pointOnCircle(c, TWOPI * (float)i / num));
+    VSR_PRECISION t = TWOPI * (float)i / num;
+    out.push_back(Round::null(o + a * cos(t) + b * sin(t)));
   }
   return out;
 };
@@ -555,16 +590,23 @@ const auto pointOnSphere = [](const DualSphere &s, VSR_PRECISION t,
                               VSR_PRECISION p) {
   return Construct::pointA(pairOnSphere(s, t, p)).null();
 };
-/// many points on sphere (could use map func from gfx::data)
+/// many points on sphere (could use map func from gfx::data), with the
+/// center and radius taken once: the point at theta t and phi p lies in the
+/// direction (cos p cos t, -sin p, -cos p sin t) from the center
 const auto pointsOnSphere = [](const DualSphere &s, int u, int v) {
+  auto o = Vec(Round::location(s));
+  auto r = Round::radius(s);
   vector<Point> out;
+  out.reserve(u * v);
   for (int i = 0; i < u; ++i) {
+    float tu = TWOPI * i / u; //-1 + 2.0 * i/num;
+    VSR_PRECISION cu = cos(tu);
+    VSR_PRECISION su = sin(tu);
     for (int j = 0; j < v; ++j) {
-
-      float tu = TWOPI * i / u; //-1 + 2.0 * i/num;
       float tv = -PIOVERTWO + VSR_PI * j / v;
-
-      out.push_back(pointOnSphere(s, tu, tv));
+      VSR_PRECISION cv = cos(tv);
+      Vec d(cv * cu, -sin(tv), -cv * su);
+      out.push_back(Round::null(o + d * r));
     }
   }
   return out;
@@ -167,19 +167,23 @@ struct Round {
   }
 
   // Split Points from Point Pair
-  static std::vector<Point> split(const Pair &pp);
+  static std::array<Point, 2> split(const Pair &pp);
 
   // Split Points from Point Pair and normalize
-  static std::vector<Point> splitLocation(const Pair &pp);
+  static std::array<Point, 2> splitLocation(const Pair &pp);
 
   // Split a point pair and return one
   static Point split(const Pair &pp, bool bFirst);
 
   // Split A Circle into its dual point pair poles
-  static std::vector<Point> split(const Circle &nc) { return split(nc.dual()); }
+  static std::array<Point, 2> split(const Circle &nc) {
+    return split(nc.dual());
+  }
 
   // Split A Circle into its dual point pair poles and normalize
-  static std::vector<Point> splitLocation(const Circle &nc) { return splitLocation(nc.dual()); }
+  static std::array<Point, 2> splitLocation(const Circle &nc) {
+    return splitLocation(nc.dual());
+  }
 
   // Direction of a Pair
   static DirectionVector direction(const Pair &p);
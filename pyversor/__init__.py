@@ -1,6 +1,23 @@
-from . import e3d
-from . import e41
-from . import c3d
-from . import c2d
-from . import sta
-from . import visuals
+import importlib
+import sys
+
+# Subpackages are imported on first attribute access so that a process that
+# only needs e.g. pyversor.e3d does not pay for registering the other algebras.
+_submodules = ('e3d', 'e41', 'c3d', 'c2d', 'sta', 'visuals')
+
+if sys.version_info >= (3, 7):
+    def __getattr__(name):
+        if name in _submodules:
+            return importlib.import_module('.' + name, __name__)
+        raise AttributeError(
+            "module '{}' has no attribute '{}'".format(__name__, name))
+
+    def __dir__():
+        return sorted(list(globals()) + list(_submodules))
+else:
+    from . import e3d
+    from . import e41
+    from . import c3d
+    from . import c2d
+    from . import sta
+    from . import visuals
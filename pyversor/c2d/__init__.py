@@ -1 +1,4 @@
+from __pyversor__ import load_submodule
+load_submodule('c2d')
+
 from __pyversor__.c2d import *
@@ -1,3 +1,6 @@
+from __pyversor__ import load_submodule
+load_submodule('c3d')
+
 from __pyversor__.c3d import (
     Vector,
     Bivector,
@@ -17,6 +20,10 @@ from . import rounds
 from . import directions
 from . import tangents
 from . import versors
+from . import batch
+from . import spatial
+from . import fit
+from . import kinematics
 
 
 ni = Infinity(1.0)
@@ -33,5 +33,6 @@ from __pyversor__.c3d.versors import (
     Translator,
     Motor,
     ConformalRotor,
-    Boost
+    Boost,
+    Dilator
 )
@@ -1 +1,4 @@
+from __pyversor__ import load_submodule
+load_submodule('e3d')
+
 from __pyversor__.e3d import *
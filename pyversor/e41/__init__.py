@@ -1,6 +1,4 @@
-from __pyversor__.e41 import *
-
-
-
-
+from __pyversor__ import load_submodule
+load_submodule('e41')
 
+from __pyversor__.e41 import *
@@ -1 +1,4 @@
+from __pyversor__ import load_submodule
+load_submodule('sta')
+
 from __pyversor__.sta import *
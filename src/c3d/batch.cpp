@@ -0,0 +1,491 @@
+// Copyright (c) 2015, Lars Tingelstad
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of pyversor nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#include <pyversor/c3d/batch.h>
+
+namespace pyversor {
+
+namespace c3d {
+
+namespace {
+
+// out = f(in) elementwise, `in` has `num_in` and out `num_out` coefficients.
+template <typename F>
+array_t unary(const array_t &in, py::ssize_t num_in, py::ssize_t num_out,
+              const char *name, F f) {
+  auto n = batch_size(in, num_in, name);
+  auto out = batch_like(in, num_out);
+  auto src = in.data();
+  auto dst = out.mutable_data();
+  {
+    py::gil_scoped_release release;
+    f(n, src, dst);
+  }
+  return out;
+}
+
+// out = f(a, b) elementwise with broadcasting of single elements, out has the
+// layout of `b`.
+template <typename F>
+array_t binary(const array_t &a, py::ssize_t num_a, const array_t &b,
+               py::ssize_t num_b, const char *name_a, const char *name_b,
+               F f) {
+  auto na = batch_size(a, num_a, name_a);
+  auto nb = batch_size(b, num_b, name_b);
+  auto n = broadcast_size(na, nb);
+  auto out = batch_like(nb == n ? b : a, num_b);
+  std::size_t a_inc = na == 1 ? 0 : num_a;
+  std::size_t b_inc = nb == 1 ? 0 : num_b;
+  auto pa = a.data();
+  auto pb = b.data();
+  auto dst = out.mutable_data();
+  {
+    py::gil_scoped_release release;
+    f(n, pa, a_inc, pb, b_inc, dst);
+  }
+  return out;
+}
+
+// Matrices f(v) with `rows` rows of `cols` columns of the versors v with `num`
+// coefficients.
+template <typename F>
+array_t to_matrix(const array_t &v, py::ssize_t num, const char *name,
+                  std::size_t rows, std::size_t cols, F f) {
+  if (rows != 3 && rows != 4) {
+    throw py::value_error("rows must be 3 or 4");
+  }
+  auto n = batch_size(v, num, name);
+  auto shape = batch_shape(v);
+  shape.push_back(static_cast<py::ssize_t>(rows));
+  shape.push_back(static_cast<py::ssize_t>(cols));
+  array_t out(shape);
+  auto src = v.data();
+  auto dst = out.mutable_data();
+  {
+    py::gil_scoped_release release;
+    f(n, src, dst);
+  }
+  return out;
+}
+
+// Versors f(x) with `num` coefficients of the 3 by 4 or 4 by 4 matrices x,
+// or also 3 by 3 ones if `rotations`.
+template <typename F>
+array_t from_matrix(const array_t &x, py::ssize_t num, bool rotations,
+                    F f) {
+  auto d = x.ndim();
+  auto rows = d < 2 ? 0 : x.shape(d - 2);
+  auto cols = d < 2 ? 0 : x.shape(d - 1);
+  bool valid = (rows == 3 || rows == 4) && cols == 4;
+  if (!valid && !(rotations && rows == 3 && cols == 3)) {
+    throw py::value_error(rotations ? "matrices must have shape (..., 3, 3), "
+                                      "(..., 3, 4) or (..., 4, 4)"
+                                    : "matrices must have shape (..., 3, 4) "
+                                      "or (..., 4, 4)");
+  }
+  std::vector<py::ssize_t> shape(x.shape(), x.shape() + d - 2);
+  shape.push_back(num);
+  array_t out(shape);
+  auto n = static_cast<std::size_t>(x.size() / (rows * cols));
+  auto src = x.data();
+  auto dst = out.mutable_data();
+  {
+    py::gil_scoped_release release;
+    f(n, src, static_cast<std::size_t>(rows), static_cast<std::size_t>(cols),
+      dst);
+  }
+  return out;
+}
+
+// Shape of the output of an elementwise operation on `a` with `num_a`
+// coefficients and the scalars t, broadcasting single elements of either, with
+// `num` coefficients per element.
+std::vector<py::ssize_t> scalar_broadcast(const array_t &a, py::ssize_t num_a,
+                                          const array_t &t, py::ssize_t num,
+                                          const char *name, std::size_t &n) {
+  auto na = batch_size(a, num_a, name);
+  auto nt = static_cast<std::size_t>(t.size());
+  n = broadcast_size(na, nt);
+  std::vector<py::ssize_t> shape;
+  if (na == n) {
+    shape = batch_shape(a);
+  } else {
+    shape.assign(t.shape(), t.shape() + t.ndim());
+  }
+  shape.push_back(num);
+  return shape;
+}
+
+// out = f(a, b, t) elementwise on the points a and b and the scalars t,
+// broadcasting single elements of any of them, with `num` coefficients per
+// element of out.
+template <typename F>
+array_t geodesic(const array_t &a, const array_t &b, const array_t &t,
+                 py::ssize_t num, F f) {
+  auto na = batch_size(a, 5, "a");
+  auto nb = batch_size(b, 5, "b");
+  auto nt = static_cast<std::size_t>(t.size());
+  auto n = broadcast_size(broadcast_size(na, nb), nt);
+  std::vector<py::ssize_t> shape;
+  if (na == n) {
+    shape = batch_shape(a);
+  } else if (nb == n) {
+    shape = batch_shape(b);
+  } else {
+    shape.assign(t.shape(), t.shape() + t.ndim());
+  }
+  shape.push_back(num);
+  array_t out(shape);
+  std::size_t a_inc = na == 1 ? 0 : 5;
+  std::size_t b_inc = nb == 1 ? 0 : 5;
+  std::size_t t_inc = nt == 1 ? 0 : 1;
+  auto pa = a.data();
+  auto pb = b.data();
+  auto pt = t.data();
+  auto dst = out.mutable_data();
+  {
+    py::gil_scoped_release release;
+    f(n, pa, a_inc, pb, b_inc, pt, t_inc, dst);
+  }
+  return out;
+}
+
+} // namespace
+
+std::vector<double> dual_lines(const array_t &lines, bool dual) {
+  auto m = batch_size(lines, 6, "lines");
+  std::vector<double> dll(lines.data(), lines.data() + 6 * m);
+  if (!dual) {
+    raycast::dual_lines(m, lines.data(), dll.data());
+  }
+  return dll;
+}
+
+const double *ray_origins(const py::object &origins, std::size_t m,
+                          array_t &storage) {
+  if (origins.is_none()) {
+    return nullptr;
+  }
+  storage = origins.cast<array_t>();
+  if (batch_size(storage, 3, "origins") != m) {
+    throw py::value_error("origins must have one point per line");
+  }
+  return storage.data();
+}
+
+void def_batch(py::module &m) {
+  auto batch = m.def_submodule("batch");
+  // Select the kernels for this CPU when the module is imported.
+  kernels::get();
+  batch.def("isa", []() { return std::string(kernels::get().isa); });
+  batch.def("available_isas", &kernels::available);
+  batch.def("select_isa", &kernels::select);
+
+  batch.def("null", [](const array_t &x) {
+    return unary(x, 3, 5, "x", kernels::get().null);
+  });
+  batch.def("normalize", [](const array_t &p) {
+    return unary(p, 5, 5, "p", kernels::get().normalize);
+  });
+  batch.def("exp", [](const array_t &dll) {
+    return unary(dll, 6, 8, "dll", kernels::get().motor_exp);
+  });
+  batch.def("log", [](const array_t &mot) {
+    return unary(mot, 8, 6, "mot", kernels::get().motor_log);
+  });
+  batch.def("normalize_motors", [](const array_t &mot) {
+    return unary(mot, 8, 8, "mot", kernels::get().motor_normalize);
+  });
+  batch.def("geometric", [](const array_t &a, const array_t &b) {
+    return binary(a, 8, b, 8, "a", "b", kernels::get().motor_product);
+  });
+  batch.def("spin", [](const array_t &p, const array_t &mot) {
+    return binary(mot, 8, p, 5, "mot", "p",
+                  [](std::size_t n, const double *m, std::size_t m_inc,
+                     const double *p, std::size_t p_inc, double *out) {
+                    kernels::get().motor_spin(n, p, p_inc, m, m_inc, out);
+                  });
+  });
+
+  batch.def("boost", [](const array_t &pairs) {
+    return unary(pairs, 10, 11, "pairs", kernels::get().boost);
+  });
+  batch.def("boost_spin", [](const array_t &p, const array_t &pairs) {
+    return binary(pairs, 10, p, 5, "pairs", "p",
+                  [](std::size_t n, const double *b, std::size_t b_inc,
+                     const double *p, std::size_t p_inc, double *out) {
+                    kernels::get().boost_spin(n, p, p_inc, b, b_inc, out);
+                  });
+  });
+  batch.def("dilator", [](const array_t &points, const array_t &t) {
+    std::size_t n;
+    auto shape = scalar_broadcast(points, 5, t, 5, "points", n);
+    array_t out(shape);
+    std::size_t p_inc = batch_size(points, 5, "points") == 1 ? 0 : 5;
+    std::size_t t_inc = t.size() == 1 ? 0 : 1;
+    auto pp = points.data();
+    auto pt = t.data();
+    auto dst = out.mutable_data();
+    {
+      py::gil_scoped_release release;
+      kernels::get().dilator(n, pp, p_inc, pt, t_inc, dst);
+    }
+    return out;
+  });
+  batch.def("dilate", [](const array_t &p, const array_t &points,
+                         const array_t &t) {
+    std::size_t n;
+    auto shape = scalar_broadcast(points, 5, t, 5, "points", n);
+    auto np = batch_size(p, 5, "p");
+    n = broadcast_size(np, n);
+    if (np == n) {
+      shape = batch_shape(p);
+      shape.push_back(5);
+    }
+    array_t out(shape);
+    std::size_t x_inc = np == 1 ? 0 : 5;
+    std::size_t c_inc = batch_size(points, 5, "points") == 1 ? 0 : 5;
+    std::size_t t_inc = t.size() == 1 ? 0 : 1;
+    auto px = p.data();
+    auto pc = points.data();
+    auto pt = t.data();
+    auto dst = out.mutable_data();
+    {
+      py::gil_scoped_release release;
+      kernels::get().dilate(n, px, x_inc, pc, c_inc, pt, t_inc, dst);
+    }
+    return out;
+  });
+
+  batch.def("hnorm", [](const array_t &p) {
+    return unary(p, 5, 5, "points", hyperbolic::normalize);
+  });
+  batch.def("hdist", [](const array_t &a, const array_t &b) {
+    auto na = batch_size(a, 5, "a");
+    auto nb = batch_size(b, 5, "b");
+    auto n = broadcast_size(na, nb);
+    array_t out(batch_shape(na == n ? a : b));
+    std::size_t a_inc = na == 1 ? 0 : 5;
+    std::size_t b_inc = nb == 1 ? 0 : 5;
+    auto pa = a.data();
+    auto pb = b.data();
+    auto dst = out.mutable_data();
+    {
+      py::gil_scoped_release release;
+      hyperbolic::distance(n, pa, a_inc, pb, b_inc, dst);
+    }
+    return out;
+  });
+  batch.def("hgen", [](const array_t &a, const array_t &b, const array_t &t) {
+    return geodesic(a, b, t, 10, hyperbolic::generator);
+  });
+  batch.def("hspin", [](const array_t &a, const array_t &b, const array_t &t) {
+    return geodesic(a, b, t, 5, hyperbolic::spin);
+  });
+
+  batch.def(
+      "motor_to_matrix",
+      [](const array_t &mot, std::size_t rows) {
+        return to_matrix(mot, 8, "mot", rows, 4,
+                         [&](std::size_t n, const double *m, double *out) {
+                           convert::motor_matrix(n, m, 8, rows, 4, out);
+                         });
+      },
+      py::arg("mot"), py::arg("rows") = 4);
+  batch.def("matrix_to_motor", [](const array_t &x) {
+    return from_matrix(x, 8, true,
+                       [](std::size_t n, const double *x, std::size_t rows,
+                          std::size_t cols, double *out) {
+                         convert::matrix_motor(n, x, rows, cols, out, 8);
+                       });
+  });
+  batch.def("rotator_to_matrix", [](const array_t &rot) {
+    return to_matrix(rot, 4, "rot", 3, 3,
+                     [](std::size_t n, const double *r, double *out) {
+                       convert::motor_matrix(n, r, 4, 3, 3, out);
+                     });
+  });
+  batch.def("matrix_to_rotator", [](const array_t &x) {
+    return from_matrix(x, 4, true,
+                       [](std::size_t n, const double *x, std::size_t rows,
+                          std::size_t cols, double *out) {
+                         convert::matrix_motor(n, x, rows, cols, out, 4);
+                       });
+  });
+  batch.def(
+      "translator_to_matrix",
+      [](const array_t &trs, std::size_t rows) {
+        return to_matrix(trs, 4, "trs", rows, 4,
+                         [&](std::size_t n, const double *t, double *out) {
+                           convert::translator_matrix(n, t, rows, out);
+                         });
+      },
+      py::arg("trs"), py::arg("rows") = 4);
+  batch.def("matrix_to_translator", [](const array_t &x) {
+    return from_matrix(x, 4, false,
+                       [](std::size_t n, const double *x, std::size_t rows,
+                          std::size_t, double *out) {
+                         convert::matrix_translator(n, x, rows, out);
+                       });
+  });
+  batch.def(
+      "dilator_to_matrix",
+      [](const array_t &dil, std::size_t rows) {
+        return to_matrix(dil, 2, "dil", rows, 4,
+                         [&](std::size_t n, const double *d, double *out) {
+                           convert::dilator_matrix(n, d, rows, out);
+                         });
+      },
+      py::arg("dil"), py::arg("rows") = 4);
+  batch.def("matrix_to_dilator", [](const array_t &x) {
+    return from_matrix(x, 2, true,
+                       [](std::size_t n, const double *x, std::size_t rows,
+                          std::size_t cols, double *out) {
+                         convert::matrix_dilator(n, x, rows, cols, out);
+                       });
+  });
+  batch.def("rotator_to_quaternion", [](const array_t &rot) {
+    return unary(rot, 4, 4, "rot", convert::rotator_quaternion);
+  });
+  batch.def("quaternion_to_rotator", [](const array_t &q) {
+    return unary(q, 4, 4, "q", convert::quaternion_rotator);
+  });
+  batch.def("euler_to_rotator", [](const array_t &angles) {
+    return unary(angles, 3, 4, "angles", convert::euler_rotator);
+  });
+  batch.def("spherical_to_rotator", [](const array_t &angles) {
+    return unary(angles, 2, 4, "angles", convert::spherical_rotator);
+  });
+  batch.def("rotator_to_euler", [](const array_t &rot) {
+    return unary(rot, 4, 3, "rot", convert::rotator_euler);
+  });
+
+  batch.def(
+      "meet",
+      [](const array_t &lines, const array_t &targets, bool dual) {
+        auto dll = dual_lines(lines, dual);
+        auto m = dll.size() / 6;
+        auto n = batch_size(targets, 5, "targets");
+        auto shape = batch_shape(lines);
+        auto target_shape = batch_shape(targets);
+        shape.insert(shape.end(), target_shape.begin(), target_shape.end());
+        shape.push_back(10);
+        array_t out(shape);
+        auto s = targets.data();
+        auto dst = out.mutable_data();
+        {
+          py::gil_scoped_release release;
+          raycast::meet(m, dll.data(), n, s, dst);
+        }
+        return out;
+      },
+      py::arg("lines"), py::arg("targets"), py::arg("dual") = false);
+  batch.def("split", [](const array_t &pairs) {
+    auto n = batch_size(pairs, 10, "pairs");
+    auto shape = batch_shape(pairs);
+    py::array_t<bool> real(shape);
+    shape.push_back(2);
+    shape.push_back(5);
+    array_t points(shape);
+    auto src = pairs.data();
+    auto dst = points.mutable_data();
+    auto flags = real.mutable_data();
+    {
+      py::gil_scoped_release release;
+      raycast::split(n, src, dst, flags);
+    }
+    return py::make_tuple(points, real);
+  });
+  batch.def("circle_points", [](const array_t &circles, const array_t &t) {
+    auto n = batch_size(circles, 10, "circles");
+    auto m = static_cast<std::size_t>(t.size());
+    auto shape = batch_shape(circles);
+    shape.insert(shape.end(), t.shape(), t.shape() + t.ndim());
+    shape.push_back(5);
+    array_t out(shape);
+    auto src = circles.data();
+    auto pt = t.data();
+    auto dst = out.mutable_data();
+    {
+      py::gil_scoped_release release;
+      sampling::circle_points(n, src, m, pt, dst);
+    }
+    return out;
+  });
+  batch.def("sphere_points", [](const array_t &s, const array_t &theta,
+                                const array_t &phi) {
+    auto n = batch_size(s, 5, "dual_spheres");
+    if (theta.ndim() != 1 || phi.ndim() != 1) {
+      throw py::value_error("theta and phi must be one dimensional");
+    }
+    auto mu = static_cast<std::size_t>(theta.size());
+    auto mv = static_cast<std::size_t>(phi.size());
+    auto shape = batch_shape(s);
+    shape.push_back(static_cast<py::ssize_t>(mu));
+    shape.push_back(static_cast<py::ssize_t>(mv));
+    shape.push_back(5);
+    array_t out(shape);
+    auto src = s.data();
+    auto pt = theta.data();
+    auto pp = phi.data();
+    auto dst = out.mutable_data();
+    {
+      py::gil_scoped_release release;
+      sampling::sphere_points(n, src, mu, pt, mv, pp, dst);
+    }
+    return out;
+  });
+  batch.def(
+      "raycast",
+      [](const array_t &lines, const array_t &targets, py::object origins,
+         bool dual) {
+        auto dll = dual_lines(lines, dual);
+        auto m = dll.size() / 6;
+        auto n = batch_size(targets, 5, "targets");
+        array_t start;
+        auto o = ray_origins(origins, m, start);
+        auto shape = batch_shape(lines);
+        py::array_t<std::int64_t> index(shape);
+        array_t distance(shape);
+        auto s = targets.data();
+        auto pi = index.mutable_data();
+        auto pd = distance.mutable_data();
+        {
+          py::gil_scoped_release release;
+          raycast::nearest(m, dll.data(), o, n, s, pi, pd);
+        }
+        return py::make_tuple(index, distance);
+      },
+      py::arg("lines"), py::arg("targets"), py::arg("origins") = py::none(),
+      py::arg("dual") = false);
+}
+
+} // namespace c3d
+
+} // namespace pyversor
@@ -0,0 +1,166 @@
+// Copyright (c) 2015, Lars Tingelstad
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of pyversor nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#include <pyversor/c3d/blend.h>
+#include <pyversor/parallel.h>
+
+#include <versor/space/cga3D_op.h>
+#include <versor/space/cga3D_types.h>
+
+#include <algorithm>
+
+namespace pyversor {
+
+namespace c3d {
+
+namespace {
+
+using namespace vsr::cga;
+
+// Rotors per task, and points per task when applying them.
+constexpr std::size_t tile = 256;
+constexpr std::size_t point_tile = 4096;
+
+Con load_con(const double *c) {
+  Con con;
+  std::copy(c, c + con.Num, con.val.begin());
+  return con;
+}
+
+// Writes the pairs of `split` to out (2 x 10), padded with zeros.
+void store(const PairSplit &split, double *out, std::int64_t *count) {
+  std::fill(out, out + 20, 0.0);
+  for (int k = 0; k < split.size(); ++k) {
+    std::copy(split[k].val.begin(), split[k].val.end(), out + 10 * k);
+  }
+  if (count != nullptr) {
+    *count = split.size();
+  }
+}
+
+} // namespace
+
+blend blend::circles(const double *a, const double *b, bool flip) {
+  Cir ca, cb;
+  std::copy(a, a + ca.Num, ca.val.begin());
+  std::copy(b, b + cb.Num, cb.val.begin());
+  auto con = Gen::ratio(ca, cb, flip);
+  return blend(con.val.data());
+}
+
+blend::blend(const double *con) {
+  auto log = Gen::log(load_con(con));
+  size_ = static_cast<std::size_t>(log.size());
+  store(log, log_[0], nullptr);
+}
+
+void blend::evaluate(std::size_t m, const double *t, double *out) const {
+  parallel_for(m, tile, [&](std::size_t begin, std::size_t end) {
+    for (auto i = begin; i < end; ++i) {
+      Con c(1);
+      for (std::size_t k = 0; k < size_; ++k) {
+        Pair p;
+        std::copy(log_[k], log_[k] + 10, p.val.begin());
+        c *= Gen::bst(p * t[i]);
+      }
+      std::copy(c.val.begin(), c.val.end(), out + c.Num * i);
+    }
+  });
+}
+
+void blend::spin_matrix(double t, double *out) const {
+  Con c(1);
+  for (std::size_t k = 0; k < size_; ++k) {
+    Pair p;
+    std::copy(log_[k], log_[k] + 10, p.val.begin());
+    c *= Gen::bst(p * t);
+  }
+  for (int j = 0; j < 5; ++j) {
+    Pnt e;
+    e[j] = 1.0;
+    auto s = e.spin(c);
+    for (int r = 0; r < 5; ++r) {
+      out[5 * r + j] = s[r];
+    }
+  }
+}
+
+void blend::apply(std::size_t m, const double *t, std::size_t n,
+                  const double *p, double *out) const {
+  const auto chunks = std::max<std::size_t>((n + point_tile - 1) / point_tile,
+                                            1);
+  parallel_for(m * chunks, 1, [&](std::size_t begin, std::size_t end) {
+    for (auto task = begin; task < end; ++task) {
+      const auto i = task / chunks;
+      const auto first = (task % chunks) * point_tile;
+      const auto last = std::min(first + point_tile, n);
+      double s[25];
+      spin_matrix(t[i], s);
+      auto dst = out + 5 * n * i;
+      for (auto k = first; k < last; ++k) {
+        const double *x = p + 5 * k;
+        double y[5];
+        for (int r = 0; r < 5; ++r) {
+          y[r] = s[5 * r] * x[0] + s[5 * r + 1] * x[1] + s[5 * r + 2] * x[2] +
+                 s[5 * r + 3] * x[3] + s[5 * r + 4] * x[4];
+        }
+        const double w = 1.0 / y[3];
+        for (int r = 0; r < 5; ++r) {
+          dst[5 * k + r] = y[r] * w;
+        }
+      }
+    }
+  });
+}
+
+void split_pairs(std::size_t n, const double *par, double *out,
+                 std::int64_t *count) {
+  parallel_for(n, tile, [&](std::size_t begin, std::size_t end) {
+    for (auto i = begin; i < end; ++i) {
+      Pair p;
+      std::copy(par + 10 * i, par + 10 * i + 10, p.val.begin());
+      store(Gen::split(p), out + 20 * i,
+            count == nullptr ? nullptr : count + i);
+    }
+  });
+}
+
+void split_logs(std::size_t n, const double *con, double *out,
+                std::int64_t *count) {
+  parallel_for(n, tile, [&](std::size_t begin, std::size_t end) {
+    for (auto i = begin; i < end; ++i) {
+      store(Gen::log(load_con(con + 16 * i)), out + 20 * i,
+            count == nullptr ? nullptr : count + i);
+    }
+  });
+}
+
+} // namespace c3d
+
+} // namespace pyversor
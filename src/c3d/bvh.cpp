@@ -0,0 +1,541 @@
+// Copyright (c) 2015, Lars Tingelstad
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of pyversor nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#include <pyversor/c3d/bvh.h>
+#include <pyversor/parallel.h>
+
+#include "hits.h"
+
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+namespace pyversor {
+
+namespace c3d {
+
+namespace {
+
+using namespace hits;
+
+// Primitives or queries per task.
+constexpr std::size_t tile = 1024;
+// Deep enough for the 30 bit Morton codes extended by the primitive index.
+constexpr int max_depth = 128;
+
+constexpr double infinity = std::numeric_limits<double>::infinity();
+
+// Checked before allocating the primitives, since node children are 32 bit.
+void check_size(std::size_t n) {
+  if (n > static_cast<std::size_t>(std::numeric_limits<std::int32_t>::max())) {
+    throw std::length_error("Too many primitives for a bvh");
+  }
+}
+
+void store(const Pnt &p, double *out) {
+  std::copy(p.val.begin(), p.val.end(), out);
+}
+
+// Normalized dual sphere at Round::location(r) with Round::radius(r).
+template <typename T> void bound(const T &r, double *sphere, double &radius) {
+  radius = Round::radius(r);
+  store(Round::dls(Round::location(r), radius), sphere);
+}
+
+// Normalized dual plane carrying the circle `cir`, as a conformal vector.
+void carrier(const Cir &cir, double *plane) {
+  auto dlp = Round::carrier(cir).dual();
+  auto norm = std::sqrt(dlp[0] * dlp[0] + dlp[1] * dlp[1] + dlp[2] * dlp[2]);
+  plane[0] = dlp[0] / norm;
+  plane[1] = dlp[1] / norm;
+  plane[2] = dlp[2] / norm;
+  plane[3] = 0.0;
+  plane[4] = dlp[3] / norm;
+}
+
+double inner(const double *a, const double *b) {
+  return (load_dls(a) <= load_dls(b))[0];
+}
+
+// Distance from the null point `p` to the disc of a circle with normalized
+// surround `sphere` of `radius` and normalized carrier `plane`.
+double disc_distance(const Pnt &p, const double *sphere, double radius,
+                     const double *plane) {
+  auto h = (p <= load_dls(plane))[0];
+  auto d2 = radius * radius - 2.0 * (p <= load_dls(sphere))[0];
+  auto rho = std::sqrt(std::max(d2 - h * h, 0.0));
+  auto e = std::max(rho - radius, 0.0);
+  return std::sqrt(h * h + e * e);
+}
+
+// Interleaves the lower 10 bits of x with two zero bits.
+std::uint32_t spread(std::uint32_t x) {
+  x = (x * 0x00010001u) & 0xFF0000FFu;
+  x = (x * 0x00000101u) & 0x0F00F00Fu;
+  x = (x * 0x00000011u) & 0xC30C30C3u;
+  x = (x * 0x00000005u) & 0x49249249u;
+  return x;
+}
+
+int clz64(std::uint64_t x) {
+  return x == 0 ? 64 : __builtin_clzll(x);
+}
+
+// Float bounds that contain x.
+float down(double x) {
+  auto f = static_cast<float>(x);
+  return f > x ? std::nextafter(f, -std::numeric_limits<float>::infinity())
+               : f;
+}
+float up(double x) {
+  auto f = static_cast<float>(x);
+  return f < x ? std::nextafter(f, std::numeric_limits<float>::infinity()) : f;
+}
+
+// Whether the ray o + t d with 0 <= t <= t_max passes through the box, and
+// the distance t_min at which it enters.
+bool slab(const float *lo, const float *hi, const double *o,
+          const double *inv, double t_max, double &t_min) {
+  double t0 = 0.0;
+  double t1 = t_max;
+  for (int c = 0; c < 3; ++c) {
+    auto a = (lo[c] - o[c]) * inv[c];
+    auto b = (hi[c] - o[c]) * inv[c];
+    if (a > b) {
+      std::swap(a, b);
+    }
+    t0 = std::max(t0, a);
+    t1 = std::min(t1, b);
+    if (t0 > t1) {
+      return false;
+    }
+  }
+  t_min = t0;
+  return true;
+}
+
+// Squared distance from x to the box.
+double box_distance2(const float *lo, const float *hi, const double *x) {
+  double d2 = 0.0;
+  for (int c = 0; c < 3; ++c) {
+    auto e = std::max(std::max(lo[c] - x[c], x[c] - hi[c]), 0.0);
+    d2 += e * e;
+  }
+  return d2;
+}
+
+} // namespace
+
+bvh::bvh(kind k, std::vector<primitive> prims)
+    : kind_(k), prims_(std::move(prims)) {
+  build();
+}
+
+bvh bvh::dual_spheres(std::size_t n, const double *s) {
+  check_size(n);
+  std::vector<primitive> prims(n);
+  parallel_for(n, tile, [&](std::size_t begin, std::size_t end) {
+    for (auto i = begin; i < end; ++i) {
+      bound(load_dls(s + 5 * i), prims[i].sphere, prims[i].radius);
+    }
+  });
+  return bvh(kind::dual_sphere, std::move(prims));
+}
+
+bvh bvh::circles(std::size_t n, const double *cir) {
+  check_size(n);
+  std::vector<primitive> prims(n);
+  parallel_for(n, tile, [&](std::size_t begin, std::size_t end) {
+    for (auto i = begin; i < end; ++i) {
+      auto p = cir + 10 * i;
+      Cir c(p[0], p[1], p[2], p[3], p[4], p[5], p[6], p[7], p[8], p[9]);
+      bound(c, prims[i].sphere, prims[i].radius);
+      carrier(c, prims[i].plane);
+    }
+  });
+  return bvh(kind::circle, std::move(prims));
+}
+
+bvh bvh::pairs(std::size_t n, const double *par) {
+  check_size(n);
+  std::vector<primitive> prims(n);
+  parallel_for(n, tile, [&](std::size_t begin, std::size_t end) {
+    for (auto i = begin; i < end; ++i) {
+      auto p = load_par(par + 10 * i);
+      bound(p, prims[i].sphere, prims[i].radius);
+      auto points = Round::split(p);
+      store(Round::location(points[0]), prims[i].plane);
+      store(Round::location(points[1]), prims[i].point);
+    }
+  });
+  return bvh(kind::pair, std::move(prims));
+}
+
+bvh bvh::planes(std::size_t n, const double *dlp, const double *bounds) {
+  check_size(n);
+  std::vector<primitive> prims(n);
+  parallel_for(n, tile, [&](std::size_t begin, std::size_t end) {
+    for (auto i = begin; i < end; ++i) {
+      auto p = dlp + 4 * i;
+      auto c = Construct::meet(load_dls(bounds + 5 * i),
+                               Dlp(p[0], p[1], p[2], p[3]));
+      bound(c, prims[i].sphere, prims[i].radius);
+      carrier(c, prims[i].plane);
+    }
+  });
+  return bvh(kind::circle, std::move(prims));
+}
+
+void bvh::build() {
+  auto n = prims_.size();
+  if (n == 0) {
+    return;
+  }
+
+  // Morton codes of the locations in the box around all of them, extended by
+  // the primitive index so that every key is unique.
+  double lo[3] = {infinity, infinity, infinity};
+  double hi[3] = {-infinity, -infinity, -infinity};
+  for (const auto &p : prims_) {
+    for (int c = 0; c < 3; ++c) {
+      lo[c] = std::min(lo[c], p.sphere[c]);
+      hi[c] = std::max(hi[c], p.sphere[c]);
+    }
+  }
+  std::vector<std::uint64_t> keys(n);
+  parallel_for(n, tile, [&](std::size_t begin, std::size_t end) {
+    for (auto i = begin; i < end; ++i) {
+      std::uint32_t code = 0;
+      for (int c = 0; c < 3; ++c) {
+        auto extent = hi[c] - lo[c];
+        auto x = extent > 0.0 ? (prims_[i].sphere[c] - lo[c]) / extent : 0.0;
+        auto q = static_cast<std::uint32_t>(std::min(x * 1024.0, 1023.0));
+        code |= spread(q) << (2 - c);
+      }
+      keys[i] = (static_cast<std::uint64_t>(code) << 32) | i;
+    }
+  });
+  std::sort(keys.begin(), keys.end());
+  order_.resize(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    order_[i] = static_cast<std::int64_t>(keys[i] & 0xFFFFFFFFu);
+  }
+
+  // Karras, "Maximizing parallelism in the construction of BVHs, octrees and
+  // k-d trees", 2012: every internal node is built independently from the
+  // range of sorted keys it covers.
+  auto m = static_cast<std::int64_t>(n) - 1;
+  nodes_.assign(static_cast<std::size_t>(m), node());
+  std::vector<std::int32_t> parent(2 * n - 1, -1);
+  auto delta = [&](std::int64_t i, std::int64_t j) {
+    if (j < 0 || j > m) {
+      return -1;
+    }
+    return clz64(keys[i] ^ keys[j]);
+  };
+  parallel_for(m, tile, [&](std::size_t begin, std::size_t end) {
+    for (auto i = static_cast<std::int64_t>(begin);
+         i < static_cast<std::int64_t>(end); ++i) {
+      auto d = delta(i, i + 1) > delta(i, i - 1) ? 1 : -1;
+      auto d_min = delta(i, i - d);
+      std::int64_t l_max = 2;
+      while (delta(i, i + l_max * d) > d_min) {
+        l_max *= 2;
+      }
+      std::int64_t l = 0;
+      for (auto t = l_max / 2; t >= 1; t /= 2) {
+        if (delta(i, i + (l + t) * d) > d_min) {
+          l += t;
+        }
+      }
+      auto j = i + l * d;
+      auto d_node = delta(i, j);
+      std::int64_t s = 0;
+      for (std::int64_t div = 2;; div *= 2) {
+        auto t = (l + div - 1) / div;
+        if (delta(i, i + (s + t) * d) > d_node) {
+          s += t;
+        }
+        if (t == 1) {
+          break;
+        }
+      }
+      auto gamma = i + s * d + std::min(d, 0);
+      auto left = std::min(i, j) == gamma ? m + gamma : gamma;
+      auto right = std::max(i, j) == gamma + 1 ? m + gamma + 1 : gamma + 1;
+      nodes_[i].child[0] = static_cast<std::int32_t>(left);
+      nodes_[i].child[1] = static_cast<std::int32_t>(right);
+      parent[left] = static_cast<std::int32_t>(i);
+      parent[right] = static_cast<std::int32_t>(i);
+    }
+  });
+
+  // Boxes from the leaves up: every node stores its box in its parent, and the
+  // second child to finish computes the box of the parent.
+  std::unique_ptr<std::atomic<int>[]> visits(new std::atomic<int>[n]);
+  for (std::size_t i = 0; i < n; ++i) {
+    visits[i] = 0;
+  }
+  parallel_for(n, tile, [&](std::size_t begin, std::size_t end) {
+    for (auto k = begin; k < end; ++k) {
+      const auto &p = prims_[order_[k]];
+      float lo[3];
+      float hi[3];
+      for (int c = 0; c < 3; ++c) {
+        lo[c] = down(p.sphere[c] - p.radius);
+        hi[c] = up(p.sphere[c] + p.radius);
+      }
+      auto i = m + static_cast<std::int64_t>(k);
+      for (auto j = parent[i]; j >= 0; i = j, j = parent[j]) {
+        auto &nd = nodes_[j];
+        auto side = nd.child[0] == i ? 0 : 1;
+        std::copy(lo, lo + 3, nd.lo[side]);
+        std::copy(hi, hi + 3, nd.hi[side]);
+        if (visits[j].fetch_add(1, std::memory_order_acq_rel) == 0) {
+          break;
+        }
+        for (int c = 0; c < 3; ++c) {
+          lo[c] = std::min(nd.lo[0][c], nd.lo[1][c]);
+          hi[c] = std::max(nd.hi[0][c], nd.hi[1][c]);
+        }
+      }
+      if (parent[i] < 0) {
+        std::copy(lo, lo + 3, lo_);
+        std::copy(hi, hi + 3, hi_);
+      }
+    }
+  });
+}
+
+void bvh::raycast(std::size_t m, const double *dll, const double *origin,
+                  std::int64_t *index, double *distance) const {
+  parallel_for(m, tile / 16, [&](std::size_t begin, std::size_t end) {
+    for (auto i = begin; i < end; ++i) {
+      index[i] = -1;
+      distance[i] = infinity;
+      if (prims_.empty() || kind_ == kind::pair) {
+        continue;
+      }
+      auto l = load_dll(dll + 6 * i);
+      double o[3];
+      double d[3];
+      double inv[3];
+      ray(l, origin == nullptr ? nullptr : origin + 3 * i, o, d);
+      for (int c = 0; c < 3; ++c) {
+        inv[c] = 1.0 / d[c];
+      }
+      // Nodes on the stack are entered by the ray at the distance stored with
+      // them, children are pushed far to near.
+      std::int64_t stack[max_depth];
+      double enter[max_depth];
+      int top = 0;
+      if (slab(lo_, hi_, o, inv, infinity, enter[0])) {
+        stack[top++] = 0;
+      }
+      while (top > 0) {
+        --top;
+        auto j = stack[top];
+        if (enter[top] > distance[i]) {
+          continue;
+        }
+        if (!is_leaf(j)) {
+          const auto &nd = nodes_[j];
+          double t[2];
+          bool hit[2];
+          for (int c = 0; c < 2; ++c) {
+            hit[c] = slab(nd.lo[c], nd.hi[c], o, inv, distance[i], t[c]);
+          }
+          auto near = hit[1] && (!hit[0] || t[1] < t[0]) ? 1 : 0;
+          for (auto c : {1 - near, near}) {
+            if (hit[c]) {
+              stack[top] = nd.child[c];
+              enter[top++] = t[c];
+            }
+          }
+          continue;
+        }
+        auto k = leaf_primitive(j);
+        const auto &p = prims_[k];
+        Pnt hit[2];
+        if (kind_ == kind::dual_sphere) {
+          if (!split_pair(Construct::meet(l, load_dls(p.sphere)), hit[0],
+                          hit[1])) {
+            continue;
+          }
+        } else {
+          if (!split_pair(Construct::meet(l, load_dls(p.plane)), hit[0],
+                          hit[1]) ||
+              (hit[0] <= load_dls(p.sphere))[0] < 0.0) {
+            continue;
+          }
+        }
+        for (const auto &h : hit) {
+          auto t = along(o, d, h);
+          if (t >= 0.0 && t < distance[i]) {
+            distance[i] = t;
+            index[i] = k;
+          }
+        }
+      }
+    }
+  });
+}
+
+void bvh::overlap(std::size_t m, const double *s,
+                  std::vector<std::int64_t> &offsets,
+                  std::vector<std::int64_t> &indices) const {
+  std::vector<std::vector<std::int64_t>> found(m);
+  parallel_for(m, tile / 16, [&](std::size_t begin, std::size_t end) {
+    for (auto i = begin; i < end; ++i) {
+      auto q = load_dls(s + 5 * i);
+      double query[5];
+      double radius;
+      bound(q, query, radius);
+      auto center = Round::null(query[0], query[1], query[2]);
+      auto r2 = radius * radius;
+      std::int64_t stack[max_depth];
+      int top = 0;
+      if (!prims_.empty() && box_distance2(lo_, hi_, query) <= r2) {
+        stack[top++] = 0;
+      }
+      while (top > 0) {
+        auto j = stack[--top];
+        if (!is_leaf(j)) {
+          const auto &nd = nodes_[j];
+          for (int c = 0; c < 2; ++c) {
+            if (box_distance2(nd.lo[c], nd.hi[c], query) <= r2) {
+              stack[top++] = nd.child[c];
+            }
+          }
+          continue;
+        }
+        auto k = leaf_primitive(j);
+        const auto &p = prims_[k];
+        bool hit = false;
+        switch (kind_) {
+        case kind::dual_sphere:
+          hit = inner(query, p.sphere) >= -radius * p.radius;
+          break;
+        case kind::circle:
+          hit = disc_distance(center, p.sphere, p.radius, p.plane) <= radius;
+          break;
+        case kind::pair:
+          hit = inner(query, p.plane) >= 0.0 || inner(query, p.point) >= 0.0;
+          break;
+        }
+        if (hit) {
+          found[i].push_back(k);
+        }
+      }
+    }
+  });
+  offsets.assign(m + 1, 0);
+  for (std::size_t i = 0; i < m; ++i) {
+    offsets[i + 1] = offsets[i] + static_cast<std::int64_t>(found[i].size());
+  }
+  indices.resize(static_cast<std::size_t>(offsets[m]));
+  parallel_for(m, tile, [&](std::size_t begin, std::size_t end) {
+    for (auto i = begin; i < end; ++i) {
+      std::copy(found[i].begin(), found[i].end(),
+                indices.begin() + offsets[i]);
+    }
+  });
+}
+
+void bvh::nearest(std::size_t m, const double *x, std::int64_t *index,
+                  double *distance) const {
+  parallel_for(m, tile / 16, [&](std::size_t begin, std::size_t end) {
+    for (auto i = begin; i < end; ++i) {
+      index[i] = -1;
+      distance[i] = infinity;
+      auto xi = x + 3 * i;
+      auto p = Round::null(xi[0], xi[1], xi[2]);
+      // Nodes on the stack are at the squared distance stored with them,
+      // children are pushed far to near.
+      std::int64_t stack[max_depth];
+      double near2[max_depth];
+      int top = 0;
+      if (!prims_.empty()) {
+        stack[top] = 0;
+        near2[top++] = box_distance2(lo_, hi_, xi);
+      }
+      while (top > 0) {
+        --top;
+        auto j = stack[top];
+        if (near2[top] >= distance[i] * distance[i]) {
+          continue;
+        }
+        if (!is_leaf(j)) {
+          const auto &nd = nodes_[j];
+          double d2[2];
+          for (int c = 0; c < 2; ++c) {
+            d2[c] = box_distance2(nd.lo[c], nd.hi[c], xi);
+          }
+          auto near = d2[1] < d2[0] ? 1 : 0;
+          for (auto c : {1 - near, near}) {
+            if (d2[c] < distance[i] * distance[i]) {
+              stack[top] = nd.child[c];
+              near2[top++] = d2[c];
+            }
+          }
+          continue;
+        }
+        auto k = leaf_primitive(j);
+        const auto &q = prims_[k];
+        double dist = infinity;
+        switch (kind_) {
+        case kind::dual_sphere: {
+          auto d2 = q.radius * q.radius - 2.0 * (p <= load_dls(q.sphere))[0];
+          dist = std::fabs(std::sqrt(std::max(d2, 0.0)) - q.radius);
+          break;
+        }
+        case kind::circle:
+          dist = disc_distance(p, q.sphere, q.radius, q.plane);
+          break;
+        case kind::pair:
+          dist = std::sqrt(std::max(
+              -2.0 * std::max((p <= load_dls(q.plane))[0],
+                              (p <= load_dls(q.point))[0]),
+              0.0));
+          break;
+        }
+        if (dist < distance[i]) {
+          distance[i] = dist;
+          index[i] = k;
+        }
+      }
+    }
+  });
+}
+
+} // namespace c3d
+
+} // namespace pyversor
@@ -51,6 +51,10 @@ void def_submodule(py::module &m) {
   def_construct(c3d);
   def_generate(c3d);
   def_operate(c3d);
+  def_batch(c3d);
+  def_spatial(c3d);
+  def_fit(c3d);
+  def_kinematics(c3d);
 }
 
 } // namespace cga
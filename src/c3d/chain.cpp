@@ -0,0 +1,281 @@
+// Copyright (c) 2015, Lars Tingelstad
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of pyversor nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#include <pyversor/c3d/chain.h>
+#include <pyversor/c3d/kernels.h>
+#include <pyversor/parallel.h>
+
+#include <versor/space/cga3D_op.h>
+#include <versor/space/cga3D_types.h>
+
+#include "linalg.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace pyversor {
+
+namespace c3d {
+
+namespace {
+
+using namespace vsr::cga;
+
+// Configurations per task. Prefix products are reused within a task.
+constexpr std::size_t tile = 256;
+// Inverse kinematics solves per task.
+constexpr std::size_t ik_tile = 16;
+// Factorizations of a step, each with a hundred times the damping of the one
+// before, after which a solve gives up.
+constexpr int max_attempts = 8;
+
+// Jacobian columns of one configuration with link motors `links`.
+void columns(std::size_t joints, const double *axes, const double *links,
+             double *out) {
+  for (std::size_t j = 0; j < joints; ++j, axes += 6, out += 6) {
+    Dll l(axes[0], axes[1], axes[2], axes[3], axes[4], axes[5]);
+    if (j > 0) {
+      auto m = links + 8 * (j - 1);
+      l = l.spin(Mot(m[0], m[1], m[2], m[3], m[4], m[5], m[6], m[7]));
+    }
+    std::copy(l.val.begin(), l.val.end(), out);
+  }
+}
+
+} // namespace
+
+chain::chain(std::size_t joints, const double *dll, const double *home)
+    : axes_(dll, dll + 6 * joints) {
+  if (joints == 0) {
+    throw std::invalid_argument("a chain needs at least one joint");
+  }
+  std::fill(home_, home_ + 8, 0.0);
+  if (home != nullptr) {
+    std::copy(home, home + 8, home_);
+  } else {
+    home_[0] = 1.0;
+  }
+}
+
+void chain::forward(std::size_t m, const double *theta, double *links,
+                    double *end) const {
+  const auto &k = kernels::get();
+  const auto joints = size();
+  parallel_for(m, tile, [&](std::size_t begin, std::size_t stop) {
+    const auto rows = stop - begin;
+    std::vector<double> work;
+    double *link = nullptr;
+    if (links != nullptr) {
+      link = links + begin * joints * 8;
+    } else {
+      work.resize(rows * joints * 8);
+      link = work.data();
+    }
+    const double *t = theta + begin * joints;
+    // First joint of each configuration whose value differs from the
+    // configuration before it in the task.
+    std::vector<std::size_t> first(rows, 0);
+    for (std::size_t r = 1; r < rows; ++r) {
+      auto a = t + (r - 1) * joints;
+      auto b = t + r * joints;
+      first[r] = std::mismatch(a, a + joints, b).first - a;
+    }
+    std::vector<std::size_t> changed;
+    std::vector<double> dll(rows * 6);
+    std::vector<double> mot(rows * 8);
+    std::vector<double> prefix(rows * 8);
+    std::vector<double> product(rows * 8);
+    for (std::size_t j = 0; j < joints; ++j) {
+      changed.clear();
+      for (std::size_t r = 0; r < rows; ++r) {
+        if (first[r] <= j) {
+          changed.push_back(r);
+        }
+      }
+      const auto n = changed.size();
+      const double *axis = &axes_[6 * j];
+      for (std::size_t i = 0; i < n; ++i) {
+        auto v = t[changed[i] * joints + j];
+        for (int c = 0; c < 6; ++c) {
+          dll[6 * i + c] = v * axis[c];
+        }
+      }
+      k.motor_exp(n, dll.data(), mot.data());
+      const double *result = mot.data();
+      if (j > 0) {
+        for (std::size_t i = 0; i < n; ++i) {
+          auto p = link + (changed[i] * joints + j - 1) * 8;
+          std::copy(p, p + 8, &prefix[8 * i]);
+        }
+        k.motor_product(n, prefix.data(), 8, mot.data(), 8, product.data());
+        result = product.data();
+      }
+      for (std::size_t i = 0; i < n; ++i) {
+        std::copy(result + 8 * i, result + 8 * i + 8,
+                  link + (changed[i] * joints + j) * 8);
+      }
+      for (std::size_t r = 1; r < rows; ++r) {
+        if (first[r] > j) {
+          auto p = link + ((r - 1) * joints + j) * 8;
+          std::copy(p, p + 8, link + (r * joints + j) * 8);
+        }
+      }
+    }
+    if (end == nullptr) {
+      return;
+    }
+    auto e = end + begin * 8;
+    k.motor_product(rows, link + (joints - 1) * 8, joints * 8, home_, 0, e);
+  });
+}
+
+void chain::evaluate(const double *theta, double *links, double *end) const {
+  const auto &k = kernels::get();
+  const auto joints = size();
+  double dll[6];
+  double mot[8];
+  for (std::size_t j = 0; j < joints; ++j) {
+    for (int c = 0; c < 6; ++c) {
+      dll[c] = theta[j] * axes_[6 * j + c];
+    }
+    if (j == 0) {
+      k.motor_exp(1, dll, links);
+    } else {
+      k.motor_exp(1, dll, mot);
+      k.motor_product(1, links + 8 * (j - 1), 8, mot, 8, links + 8 * j);
+    }
+  }
+  k.motor_product(1, links + 8 * (joints - 1), 8, home_, 8, end);
+}
+
+void chain::jacobian(std::size_t m, const double *theta, double *out) const {
+  const auto joints = size();
+  parallel_for(m, tile, [&](std::size_t begin, std::size_t end) {
+    std::vector<double> links(joints * 8);
+    std::vector<double> effector(8);
+    for (auto r = begin; r < end; ++r) {
+      evaluate(theta + r * joints, links.data(), effector.data());
+      columns(joints, axes_.data(), links.data(), out + r * joints * 6);
+    }
+  });
+}
+
+void chain::inverse(std::size_t m, const double *targets, double *theta,
+                    const inverse_options &opts, double *residual,
+                    std::size_t *iterations) const {
+  const auto &k = kernels::get();
+  const auto joints = size();
+  const double lambda2 = opts.damping * opts.damping;
+  parallel_for(m, ik_tile, [&](std::size_t begin, std::size_t end) {
+    std::vector<double> links(joints * 8);
+    std::vector<double> jac(joints * 6);
+    double effector[8];
+    double reverse[8];
+    double delta[8];
+    double error[8];
+    for (auto r = begin; r < end; ++r) {
+      double *t = theta + r * joints;
+      const double *target = targets + 8 * r;
+      double norm = 0.0;
+      std::size_t it = 0;
+      for (;; ++it) {
+        evaluate(t, links.data(), effector);
+        for (int c = 0; c < 8; ++c) {
+          reverse[c] = (c == 0 || c == 7) ? effector[c] : -effector[c];
+        }
+        k.motor_product(1, target, 8, reverse, 8, delta);
+        // Motors M and -M are the same pose; take the error in the
+        // hemisphere of the identity so that it is the short way round.
+        if (delta[0] < 0.0) {
+          for (int c = 0; c < 8; ++c) {
+            delta[c] = -delta[c];
+          }
+        }
+        k.motor_log(1, delta, error);
+        norm = 0.0;
+        for (int c = 0; c < 6; ++c) {
+          norm += error[c] * error[c];
+        }
+        norm = std::sqrt(norm);
+        if (norm <= opts.tolerance || it == opts.max_iterations) {
+          break;
+        }
+        // d theta = J^T (J J^T + lambda^2 I)^-1 e. If round-off leaves the
+        // damped matrix without a factorization, the damping is raised.
+        columns(joints, axes_.data(), links.data(), jac.data());
+        double g[36];
+        for (int i = 0; i < 6; ++i) {
+          for (int j = 0; j < 6; ++j) {
+            double sum = 0.0;
+            for (std::size_t q = 0; q < joints; ++q) {
+              sum += jac[q * 6 + i] * jac[q * 6 + j];
+            }
+            g[i * 6 + j] = sum;
+          }
+        }
+        double a[36];
+        double l[36];
+        double y[6];
+        double mu = lambda2;
+        bool factored = false;
+        for (int attempt = 0; attempt < max_attempts && !factored; ++attempt) {
+          for (int i = 0; i < 36; ++i) {
+            a[i] = g[i] + (i % 7 == 0 ? mu : 0.0);
+          }
+          factored = linalg::cholesky(6, a, l);
+          mu = mu > 0.0 ? 100.0 * mu : 1e-12;
+        }
+        if (!factored) {
+          norm = std::numeric_limits<double>::quiet_NaN();
+          break;
+        }
+        linalg::cholesky_solve(6, l, error, y);
+        for (std::size_t q = 0; q < joints; ++q) {
+          double step = 0.0;
+          for (int i = 0; i < 6; ++i) {
+            step += jac[q * 6 + i] * y[i];
+          }
+          t[q] += step;
+        }
+      }
+      if (residual != nullptr) {
+        residual[r] = norm;
+      }
+      if (iterations != nullptr) {
+        iterations[r] = it;
+      }
+    }
+  });
+}
+
+} // namespace c3d
+
+} // namespace pyversor
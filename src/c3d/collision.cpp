@@ -0,0 +1,253 @@
+// Copyright (c) 2015, Lars Tingelstad
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of pyversor nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#include <pyversor/c3d/collision.h>
+#include <pyversor/c3d/kernels.h>
+#include <pyversor/parallel.h>
+
+#include <versor/space/cga3D_round.h>
+#include <versor/space/cga3D_types.h>
+
+#include <algorithm>
+#include <memory>
+#include <numeric>
+#include <utility>
+
+namespace pyversor {
+
+namespace c3d {
+
+namespace collision {
+
+namespace {
+
+using namespace vsr::cga;
+
+// Swept spheres per task.
+constexpr std::size_t tile = 256;
+
+using pair = std::pair<std::int64_t, std::int64_t>;
+
+// Centers (3) and radii of the `n` dual spheres in s.
+void bounds(std::size_t n, const double *s, double *center, double *radius) {
+  parallel_for(n, tile * 16, [&](std::size_t begin, std::size_t end) {
+    for (auto i = begin; i < end; ++i) {
+      auto p = s + 5 * i;
+      DualSphere d(p[0], p[1], p[2], p[3], p[4]);
+      auto c = Round::location(d);
+      std::copy(c.val.begin(), c.val.begin() + 3, center + 3 * i);
+      radius[i] = Round::radius(d);
+    }
+  });
+}
+
+// Spheres in the order of the lower ends of their intervals along the sweep
+// axis, with one array per coefficient of the normalized dual spheres taken
+// about a common origin.
+struct sweep_set {
+  std::vector<double> x, y, z, q, r, lo, hi;
+  std::vector<std::int64_t> index;
+};
+
+sweep_set sorted(std::size_t n, const double *center, const double *radius,
+                 const double *origin, int axis) {
+  std::vector<std::int64_t> order(n);
+  std::iota(order.begin(), order.end(), 0);
+  auto lower = [&](std::int64_t i) {
+    return center[3 * i + axis] - radius[i];
+  };
+  std::sort(order.begin(), order.end(), [&](std::int64_t a, std::int64_t b) {
+    return lower(a) < lower(b);
+  });
+  sweep_set s;
+  for (auto v : {&s.x, &s.y, &s.z, &s.q, &s.r, &s.lo, &s.hi}) {
+    v->resize(n);
+  }
+  s.index = order;
+  for (std::size_t k = 0; k < n; ++k) {
+    auto i = order[k];
+    auto c = center + 3 * i;
+    double x = c[0] - origin[0];
+    double y = c[1] - origin[1];
+    double z = c[2] - origin[2];
+    s.x[k] = x;
+    s.y[k] = y;
+    s.z[k] = z;
+    s.r[k] = radius[i];
+    s.q[k] = 0.5 * (x * x + y * y + z * z - radius[i] * radius[i]);
+    s.lo[k] = c[axis] - radius[i];
+    s.hi[k] = c[axis] + radius[i];
+  }
+  return s;
+}
+
+// Origin and sweep axis for the spheres of both sets: the middle of the box
+// around their centers and its longest side.
+void frame(std::size_t n, const double *a, std::size_t m, const double *b,
+           double *origin, int &axis) {
+  double lo[3], hi[3];
+  for (int c = 0; c < 3; ++c) {
+    lo[c] = n > 0 ? a[c] : (m > 0 ? b[c] : 0.0);
+    hi[c] = lo[c];
+  }
+  for (std::size_t i = 0; i < n + m; ++i) {
+    auto p = i < n ? a + 3 * i : b + 3 * (i - n);
+    for (int c = 0; c < 3; ++c) {
+      lo[c] = std::min(lo[c], p[c]);
+      hi[c] = std::max(hi[c], p[c]);
+    }
+  }
+  axis = 0;
+  for (int c = 0; c < 3; ++c) {
+    origin[c] = 0.5 * (lo[c] + hi[c]);
+    if (hi[c] - lo[c] > hi[axis] - lo[axis]) {
+      axis = c;
+    }
+  }
+}
+
+// Tests each sphere of p against the spheres of s whose intervals start
+// within its own interval: after it in the order of s when p and s are the
+// same set, strictly after its start when `strict`, and at or after it
+// otherwise. Overlapping pairs are appended to `found`, one list per task,
+// with the index of the sphere of p first unless `swap`.
+void sweep(const sweep_set &p, const sweep_set &s, bool self, bool strict,
+           bool swap, std::vector<std::vector<pair>> &found) {
+  const auto &k = kernels::get();
+  const auto n = p.index.size();
+  const auto offset = found.size();
+  found.resize(offset + (n + tile - 1) / tile);
+  parallel_for(n, tile, [&](std::size_t begin, std::size_t end) {
+    auto &out = found[offset + begin / tile];
+    std::unique_ptr<bool[]> hit;
+    std::size_t capacity = 0;
+    for (auto i = begin; i < end; ++i) {
+      std::size_t first;
+      if (self) {
+        first = i + 1;
+      } else if (strict) {
+        first = std::upper_bound(s.lo.begin(), s.lo.end(), p.lo[i]) -
+                s.lo.begin();
+      } else {
+        first = std::lower_bound(s.lo.begin(), s.lo.end(), p.lo[i]) -
+                s.lo.begin();
+      }
+      std::size_t last =
+          std::upper_bound(s.lo.begin() + first, s.lo.end(), p.hi[i]) -
+          s.lo.begin();
+      if (first >= last) {
+        continue;
+      }
+      auto len = last - first;
+      if (len > capacity) {
+        capacity = std::max(len, 2 * capacity);
+        hit.reset(new bool[capacity]);
+      }
+      const double params[5] = {p.x[i], p.y[i], p.z[i], p.q[i], p.r[i]};
+      if (k.overlaps(len, &s.x[first], &s.y[first], &s.z[first], &s.q[first],
+                     &s.r[first], params, hit.get()) == 0) {
+        continue;
+      }
+      for (std::size_t j = 0; j < len; ++j) {
+        if (!hit[j]) {
+          continue;
+        }
+        auto a = p.index[i];
+        auto b = s.index[first + j];
+        if (self && b < a) {
+          std::swap(a, b);
+        }
+        out.emplace_back(swap ? b : a, swap ? a : b);
+      }
+    }
+  });
+}
+
+void collect(std::vector<std::vector<pair>> &found,
+             std::vector<std::int64_t> &first,
+             std::vector<std::int64_t> &second) {
+  std::vector<pair> all;
+  std::size_t total = 0;
+  for (const auto &f : found) {
+    total += f.size();
+  }
+  all.reserve(total);
+  for (const auto &f : found) {
+    all.insert(all.end(), f.begin(), f.end());
+  }
+  std::sort(all.begin(), all.end());
+  first.resize(total);
+  second.resize(total);
+  for (std::size_t i = 0; i < total; ++i) {
+    first[i] = all[i].first;
+    second[i] = all[i].second;
+  }
+}
+
+} // namespace
+
+void pairs(std::size_t n, const double *s, std::vector<std::int64_t> &first,
+           std::vector<std::int64_t> &second) {
+  std::vector<double> center(3 * n);
+  std::vector<double> radius(n);
+  bounds(n, s, center.data(), radius.data());
+  double origin[3];
+  int axis;
+  frame(n, center.data(), 0, nullptr, origin, axis);
+  auto set = sorted(n, center.data(), radius.data(), origin, axis);
+  std::vector<std::vector<pair>> found;
+  sweep(set, set, true, false, false, found);
+  collect(found, first, second);
+}
+
+void pairs(std::size_t n, const double *a, std::size_t m, const double *b,
+           std::vector<std::int64_t> &first,
+           std::vector<std::int64_t> &second) {
+  std::vector<double> center(3 * (n + m));
+  std::vector<double> radius(n + m);
+  bounds(n, a, center.data(), radius.data());
+  bounds(m, b, center.data() + 3 * n, radius.data() + n);
+  double origin[3];
+  int axis;
+  frame(n, center.data(), m, center.data() + 3 * n, origin, axis);
+  auto sa = sorted(n, center.data(), radius.data(), origin, axis);
+  auto sb = sorted(m, center.data() + 3 * n, radius.data() + n, origin, axis);
+  // Each overlapping pair is found from the sphere whose interval starts
+  // first, with ties going to the sphere of a.
+  std::vector<std::vector<pair>> found;
+  sweep(sa, sb, false, false, false, found);
+  sweep(sb, sa, false, true, true, found);
+  collect(found, first, second);
+}
+
+} // namespace collision
+
+} // namespace c3d
+
+} // namespace pyversor
@@ -42,6 +42,23 @@ void def_construct(py::module &m) {
   construct.def("meet", [](const c3d::vector_t &p, const c3d::vector_t &q) {
     return Construct::meet(p, q);
   });
+  construct.def("meet", [](const c3d::line_t &l, const c3d::vector_t &s) {
+    return Construct::meet(l, s);
+  });
+  construct.def("meet",
+                [](const c3d::dual_line_t &l, const c3d::vector_t &s) {
+                  return Construct::meet(l, s);
+                });
+  construct.def("point", [](const c3d::circle_t &c, double t) {
+    return Construct::point(c, t);
+  });
+  construct.def("points_on_circle", [](const c3d::circle_t &c, int num) {
+    return vsr::cga::pointsOnCircle(c, num);
+  });
+  construct.def("points_on_sphere",
+                [](const c3d::dual_sphere_t &s, int u, int v) {
+                  return vsr::cga::pointsOnSphere(s, u, v);
+                });
 }
 
 } // namespace cga
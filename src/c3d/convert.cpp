@@ -0,0 +1,219 @@
+// Copyright (c) 2015, Lars Tingelstad
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of pyversor nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#include <pyversor/c3d/convert.h>
+#include <pyversor/c3d/kernels.h>
+#include <pyversor/parallel.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace pyversor {
+
+namespace c3d {
+
+namespace convert {
+
+namespace {
+
+// Conversions per task.
+constexpr std::size_t tile = 4096;
+
+// Sets the last row of 4 by 4 matrices to (0, 0, 0, 1).
+void last_row(std::size_t n, std::size_t rows, double *out) {
+  if (rows != 4) {
+    return;
+  }
+  for (std::size_t i = 0; i < n; ++i, out += 16) {
+    out[12] = out[13] = out[14] = 0.0;
+    out[15] = 1.0;
+  }
+}
+
+// Identity 3 by 4 or 4 by 4 matrix with diagonal k and translation t.
+void affine(double k, const double *t, std::size_t rows, double *out) {
+  for (std::size_t i = 0; i < 4 * rows; ++i) {
+    out[i] = 0.0;
+  }
+  for (std::size_t i = 0; i < 3; ++i) {
+    out[5 * i] = k;
+    out[4 * i + 3] = t[i];
+  }
+  if (rows == 4) {
+    out[15] = 1.0;
+  }
+}
+
+} // namespace
+
+void motor_matrix(std::size_t n, const double *m, std::size_t m_inc,
+                  std::size_t rows, std::size_t cols, double *out) {
+  const auto &k = kernels::get();
+  const std::size_t size = rows * cols;
+  parallel_for(n, tile, [&](std::size_t begin, std::size_t end) {
+    k.motor_matrix(end - begin, m + m_inc * begin, m_inc, cols,
+                   out + size * begin, size);
+    last_row(end - begin, rows, out + size * begin);
+  });
+}
+
+void matrix_motor(std::size_t n, const double *x, std::size_t rows,
+                  std::size_t cols, double *out, std::size_t out_inc) {
+  const auto &k = kernels::get();
+  const std::size_t size = rows * cols;
+  parallel_for(n, tile, [&](std::size_t begin, std::size_t end) {
+    k.matrix_motor(end - begin, x + size * begin, size, cols,
+                   out + out_inc * begin, out_inc);
+  });
+}
+
+void translator_matrix(std::size_t n, const double *t, std::size_t rows,
+                       double *out) {
+  for (std::size_t i = 0; i < n; ++i, t += 4, out += 4 * rows) {
+    const double s = -2.0 / t[0];
+    const double v[3] = {s * t[1], s * t[2], s * t[3]};
+    affine(1.0, v, rows, out);
+  }
+}
+
+void matrix_translator(std::size_t n, const double *x, std::size_t rows,
+                       double *out) {
+  for (std::size_t i = 0; i < n; ++i, x += 4 * rows, out += 4) {
+    out[0] = 1.0;
+    out[1] = -0.5 * x[3];
+    out[2] = -0.5 * x[7];
+    out[3] = -0.5 * x[11];
+  }
+}
+
+void dilator_matrix(std::size_t n, const double *d, std::size_t rows,
+                    double *out) {
+  const double zero[3] = {0.0, 0.0, 0.0};
+  for (std::size_t i = 0; i < n; ++i, d += 2, out += 4 * rows) {
+    // Gen::dil(t) = (cosh(t / 2), sinh(t / 2)) scales by exp(t).
+    affine((d[0] + d[1]) / (d[0] - d[1]), zero, rows, out);
+  }
+}
+
+void matrix_dilator(std::size_t n, const double *x, std::size_t rows,
+                    std::size_t cols, double *out) {
+  for (std::size_t i = 0; i < n; ++i, x += rows * cols, out += 2) {
+    const double *r0 = x;
+    const double *r1 = x + cols;
+    const double *r2 = x + 2 * cols;
+    const double det = r0[0] * (r1[1] * r2[2] - r1[2] * r2[1]) -
+                       r0[1] * (r1[0] * r2[2] - r1[2] * r2[0]) +
+                       r0[2] * (r1[0] * r2[1] - r1[1] * r2[0]);
+    const double h = std::sqrt(std::cbrt(det));
+    out[0] = 0.5 * (h + 1.0 / h);
+    out[1] = 0.5 * (h - 1.0 / h);
+  }
+}
+
+void rotator_quaternion(std::size_t n, const double *r, double *out) {
+  for (std::size_t i = 0; i < n; ++i, r += 4, out += 4) {
+    const double q[4] = {r[0], -r[3], r[2], -r[1]};
+    std::copy(q, q + 4, out);
+  }
+}
+
+void quaternion_rotator(std::size_t n, const double *q, double *out) {
+  for (std::size_t i = 0; i < n; ++i, q += 4, out += 4) {
+    const double r[4] = {q[0], -q[3], q[2], -q[1]};
+    std::copy(r, r + 4, out);
+  }
+}
+
+void euler_rotator(std::size_t n, const double *a, double *out) {
+  parallel_for(n, tile, [&](std::size_t begin, std::size_t end) {
+    for (auto i = begin; i < end; ++i) {
+      auto x = a + 3 * i;
+      auto r = out + 4 * i;
+      const double cy = std::cos(0.5 * x[0]), sy = std::sin(0.5 * x[0]);
+      const double cp = std::cos(0.5 * x[1]), sp = std::sin(0.5 * x[1]);
+      const double cr = std::cos(0.5 * x[2]), sr = std::sin(0.5 * x[2]);
+      // (cy + sy e13)(cp + sp e23)(cr + sr e12)
+      r[0] = cy * cp * cr + sy * sp * sr;
+      r[1] = cy * cp * sr - sy * sp * cr;
+      r[2] = sy * cp * cr - cy * sp * sr;
+      r[3] = cy * sp * cr + sy * cp * sr;
+    }
+  });
+}
+
+void spherical_rotator(std::size_t n, const double *a, double *out) {
+  parallel_for(n, tile, [&](std::size_t begin, std::size_t end) {
+    for (auto i = begin; i < end; ++i) {
+      auto x = a + 2 * i;
+      auto r = out + 4 * i;
+      const double ct = std::cos(0.5 * x[0]), st = std::sin(0.5 * x[0]);
+      const double cp = std::cos(0.5 * x[1]), sp = std::sin(0.5 * x[1]);
+      // (ct + st e13)(cp + sp e12)
+      r[0] = ct * cp;
+      r[1] = ct * sp;
+      r[2] = st * cp;
+      r[3] = st * sp;
+    }
+  });
+}
+
+void rotator_euler(std::size_t n, const double *r, double *out) {
+  parallel_for(n, tile, [&](std::size_t begin, std::size_t end) {
+    for (auto i = begin; i < end; ++i) {
+      auto v = r + 4 * i;
+      auto a = out + 3 * i;
+      // Entries of the rotation matrix scaled by the squared norm, from the
+      // quaternion (w, x, y, z).
+      const double w = v[0], x = -v[3], y = v[2], z = -v[1];
+      const double norm = w * w + x * x + y * y + z * z;
+      const double m00 = w * w + x * x - y * y - z * z;
+      const double m02 = 2.0 * (x * z + w * y);
+      const double m10 = 2.0 * (x * y + w * z);
+      const double m11 = w * w - x * x + y * y - z * z;
+      const double m12 = 2.0 * (y * z - w * x);
+      const double m20 = 2.0 * (x * z - w * y);
+      const double m22 = w * w - x * x - y * y + z * z;
+      const double cos_pitch = std::hypot(m10, m11);
+      a[1] = std::atan2(m12, cos_pitch);
+      if (cos_pitch > 1e-12 * norm) {
+        a[0] = std::atan2(m02, m22);
+        a[2] = std::atan2(-m10, m11);
+      } else {
+        a[0] = std::atan2(-m20, m00);
+        a[2] = 0.0;
+      }
+    }
+  });
+}
+
+} // namespace convert
+
+} // namespace c3d
+
+} // namespace pyversor
@@ -0,0 +1,145 @@
+// Copyright (c) 2015, Lars Tingelstad
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of pyversor nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#include <pyversor/c3d/field.h>
+#include <pyversor/c3d/kernels.h>
+#include <pyversor/parallel.h>
+
+#include "hits.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace pyversor {
+
+namespace c3d {
+
+namespace field {
+
+namespace {
+
+using namespace hits;
+
+// Points per task. The coordinates of a tile and its field stay in L1 while
+// every primitive is evaluated on it.
+constexpr std::size_t tile = 512;
+
+void reset(std::size_t m, double *value, std::int64_t *index) {
+  std::fill_n(value, m, std::numeric_limits<double>::infinity());
+  std::fill_n(index, m, -1);
+}
+
+} // namespace
+
+primitives::primitives(std::size_t n, const double *s, std::size_t l,
+                       const double *dll)
+    : params_(6 * (n + l), 0.0) {
+  models_.reserve(n + l);
+  for (std::size_t i = 0; i < n; ++i) {
+    auto t = s + 5 * i;
+    auto p = params_.data() + 6 * i;
+    if (t[3] == 0.0) {
+      auto norm = std::sqrt(t[0] * t[0] + t[1] * t[1] + t[2] * t[2]);
+      for (int c = 0; c < 3; ++c) {
+        p[c] = t[c] / norm;
+      }
+      p[3] = t[4] / norm;
+      models_.push_back(model::plane);
+    } else {
+      // The normalized dual sphere is (c, 1, (c^2 - r^2) / 2).
+      double c2 = 0.0;
+      for (int c = 0; c < 3; ++c) {
+        p[c] = t[c] / t[3];
+        c2 += p[c] * p[c];
+      }
+      p[3] = std::sqrt(std::max(c2 - 2.0 * t[4] / t[3], 0.0));
+      models_.push_back(model::sphere);
+    }
+  }
+  for (std::size_t i = 0; i < l; ++i) {
+    auto p = params_.data() + 6 * (n + i);
+    ray(load_dll(dll + 6 * i), nullptr, p, p + 3);
+    models_.push_back(model::line);
+  }
+}
+
+void primitives::evaluate(std::size_t m, const double *x, const double *y,
+                          const double *z, measure f, double *value,
+                          std::int64_t *index) const {
+  const auto &k = kernels::get();
+  const bool inner = f == measure::inner;
+  for (std::size_t j = 0; j < models_.size(); ++j) {
+    k.field(static_cast<int>(models_[j]), inner, m, x, y, z,
+            params_.data() + 6 * j, static_cast<std::int64_t>(j), value,
+            index);
+  }
+}
+
+void points(std::size_t m, const double *x, const primitives &p, measure f,
+            double *value, std::int64_t *index) {
+  parallel_for(m, tile, [&](std::size_t begin, std::size_t end) {
+    double c[3][tile];
+    auto count = end - begin;
+    for (std::size_t i = 0; i < count; ++i) {
+      for (int a = 0; a < 3; ++a) {
+        c[a][i] = x[3 * (begin + i) + a];
+      }
+    }
+    reset(count, value + begin, index + begin);
+    p.evaluate(count, c[0], c[1], c[2], f, value + begin, index + begin);
+  });
+}
+
+void grid(const double *origin, const double *spacing,
+          const std::size_t *shape, const primitives &p, measure f,
+          double *value, std::int64_t *index) {
+  const auto plane = shape[1] * shape[2];
+  const auto size = shape[0] * plane;
+  parallel_for(size, tile, [&](std::size_t begin, std::size_t end) {
+    double c[3][tile];
+    auto count = end - begin;
+    for (std::size_t i = 0; i < count; ++i) {
+      auto g = begin + i;
+      const std::size_t at[3] = {g / plane, g / shape[2] % shape[1],
+                                 g % shape[2]};
+      for (int a = 0; a < 3; ++a) {
+        c[a][i] = origin[a] + spacing[a] * static_cast<double>(at[a]);
+      }
+    }
+    reset(count, value + begin, index + begin);
+    p.evaluate(count, c[0], c[1], c[2], f, value + begin, index + begin);
+  });
+}
+
+} // namespace field
+
+} // namespace c3d
+
+} // namespace pyversor
@@ -0,0 +1,240 @@
+// Copyright (c) 2015, Lars Tingelstad
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of pyversor nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#include <pyversor/c3d/fit.h>
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace pyversor {
+
+namespace c3d {
+
+namespace {
+
+using labels_t =
+    py::array_t<std::int64_t, py::array::c_style | py::array::forcecast>;
+
+// Data of an optional per point array, checking that it has `n` elements.
+template <typename T, typename A>
+const T *per_point(const py::object &obj, std::size_t n, A &storage,
+                   const char *name) {
+  if (obj.is_none()) {
+    return nullptr;
+  }
+  storage = obj.cast<A>();
+  if (static_cast<std::size_t>(storage.size()) != n) {
+    throw py::value_error(std::string(name) +
+                          " must have one entry per element");
+  }
+  return storage.data();
+}
+
+} // namespace
+
+void def_fit(py::module &m) {
+  auto fit = m.def_submodule("fit");
+
+  py::class_<fitter>(fit, "Fitter")
+      .def(py::init<std::size_t>(), py::arg("k") = 1)
+      .def("__len__", &fitter::size)
+      .def(
+          "add",
+          [](fitter &f, const array_t &x, py::object weights,
+             py::object labels) {
+            auto n = batch_size(x, 3, "points");
+            array_t w_storage;
+            labels_t l_storage;
+            auto w = per_point<double>(weights, n, w_storage, "weights");
+            auto l = per_point<std::int64_t>(labels, n, l_storage, "labels");
+            auto p = x.data();
+            py::gil_scoped_release release;
+            f.add(n, p, w, l);
+          },
+          py::arg("points"), py::arg("weights") = py::none(),
+          py::arg("labels") = py::none())
+      .def("reset", &fitter::reset)
+      .def("weights",
+           [](const fitter &f) {
+             array_t out(f.size());
+             f.weights(out.mutable_data());
+             return out;
+           })
+      .def("spheres",
+           [](const fitter &f) {
+             auto k = static_cast<py::ssize_t>(f.size());
+             array_t s({k, py::ssize_t(5)});
+             array_t rms(k);
+             f.spheres(s.mutable_data(), rms.mutable_data());
+             return py::make_tuple(s, rms);
+           })
+      .def("planes", [](const fitter &f) {
+        auto k = static_cast<py::ssize_t>(f.size());
+        array_t dlp({k, py::ssize_t(4)});
+        array_t rms(k);
+        f.planes(dlp.mutable_data(), rms.mutable_data());
+        return py::make_tuple(dlp, rms);
+      });
+
+  fit.def(
+      "residuals",
+      [](const array_t &x, const array_t &targets, py::object labels) {
+        auto n = batch_size(x, 3, "points");
+        auto last = targets.ndim() > 0 ? targets.shape(targets.ndim() - 1) : 0;
+        if (last != 5 && last != 4) {
+          throw py::value_error(
+              "targets must be dual spheres (..., 5) or dual planes (..., 4)");
+        }
+        auto width = static_cast<std::size_t>(last);
+        auto m = batch_size(targets, last, "targets");
+        labels_t l_storage;
+        auto l = per_point<std::int64_t>(labels, n, l_storage, "labels");
+        std::size_t inc = 0;
+        if (l != nullptr) {
+          for (std::size_t i = 0; i < n; ++i) {
+            if (l[i] < 0 || static_cast<std::size_t>(l[i]) >= m) {
+              throw py::index_error("labels must index into targets");
+            }
+          }
+        } else if (m != 1) {
+          if (m != n) {
+            throw py::value_error(
+                "targets must be one element, one per point or labelled");
+          }
+          inc = width;
+        }
+        array_t out(batch_shape(x));
+        auto p = x.data();
+        auto t = targets.data();
+        auto o = out.mutable_data();
+        {
+          py::gil_scoped_release release;
+          residuals(n, p, width, t, inc, l, o);
+        }
+        return out;
+      },
+      py::arg("points"), py::arg("targets"), py::arg("labels") = py::none());
+
+  fit.def(
+      "ransac",
+      [](const array_t &x, const std::string &name, double threshold,
+         double confidence, std::size_t max_iterations, std::uint64_t seed) {
+        static const std::map<std::string, ransac::model> models = {
+            {"sphere", ransac::model::sphere},
+            {"plane", ransac::model::plane},
+            {"circle", ransac::model::circle},
+            {"line", ransac::model::line}};
+        auto it = models.find(name);
+        if (it == models.end()) {
+          throw py::value_error(
+              "model must be 'sphere', 'plane', 'circle' or 'line'");
+        }
+        auto m = it->second;
+        auto n = batch_size(x, 3, "points");
+        if (n < ransac::sample_size(m)) {
+          throw py::value_error("too few points for a sample of the model");
+        }
+        ransac::options opts;
+        opts.threshold = threshold;
+        opts.confidence = confidence;
+        opts.max_iterations = max_iterations;
+        opts.seed = seed;
+        array_t out(static_cast<py::ssize_t>(ransac::model_size(m)));
+        py::array_t<bool> mask(batch_shape(x));
+        auto p = x.data();
+        auto po = out.mutable_data();
+        auto pm = mask.mutable_data();
+        ransac::result r;
+        {
+          py::gil_scoped_release release;
+          r = ransac::detect(m, n, p, opts, po, pm);
+        }
+        return py::make_tuple(out, mask, r.iterations);
+      },
+      py::arg("points"), py::arg("model"), py::arg("threshold"),
+      py::arg("confidence") = 0.99, py::arg("max_iterations") = 10000,
+      py::arg("seed") = 0);
+
+  fit.def(
+      "motors",
+      [](const array_t &sources, const array_t &targets, py::object weights,
+         bool dual) {
+        if (sources.ndim() < 2) {
+          throw py::value_error("sources must have shape (..., n, width)");
+        }
+        auto c = sources.shape(sources.ndim() - 1);
+        registration::kind k;
+        if (c == 3) {
+          k = registration::kind::points;
+        } else if (c == 4) {
+          k = registration::kind::planes;
+        } else if (c == 6) {
+          k = registration::kind::lines;
+        } else {
+          throw py::value_error(
+              "sources must hold points (3), dual planes (4) or lines (6)");
+        }
+        auto total = batch_size(sources, c, "sources");
+        if (batch_shape(targets) != batch_shape(sources) ||
+            batch_size(targets, c, "targets") != total) {
+          throw py::value_error("targets must have the shape of sources");
+        }
+        auto shape = batch_shape(sources);
+        auto n = static_cast<std::size_t>(shape.back());
+        auto problems = n > 0 ? total / n : 0;
+        shape.back() = 8;
+        array_t out(shape);
+        array_t w_storage;
+        auto w = per_point<double>(weights, total, w_storage, "weights");
+        std::vector<double> a;
+        std::vector<double> b;
+        auto pa = sources.data();
+        auto pb = targets.data();
+        if (k == registration::kind::lines) {
+          a = dual_lines(sources, dual);
+          b = dual_lines(targets, dual);
+          pa = a.data();
+          pb = b.data();
+        }
+        auto po = out.mutable_data();
+        {
+          py::gil_scoped_release release;
+          registration::motors(k, problems, n, pa, pb, w, po);
+        }
+        return out;
+      },
+      py::arg("sources"), py::arg("targets"), py::arg("weights") = py::none(),
+      py::arg("dual") = false);
+}
+
+} // namespace c3d
+
+} // namespace pyversor
@@ -0,0 +1,333 @@
+// Copyright (c) 2015, Lars Tingelstad
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of pyversor nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#include <pyversor/c3d/fitting.h>
+#include <pyversor/c3d/kernels.h>
+#include <pyversor/parallel.h>
+
+#include "linalg.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace pyversor {
+
+namespace c3d {
+
+namespace {
+
+// Points per task when adding and measuring residuals.
+constexpr std::size_t tile = 16384;
+
+constexpr double nan = std::numeric_limits<double>::quiet_NaN();
+
+// Moments of a run of points with the same label.
+struct run {
+  std::int64_t label;
+  double sums[15];
+};
+
+// Index of the moments in the sums, see kernels::table::moments.
+enum { w_, x_, xx_ = 4, q_ = 10, qx_, qq_ = 14 };
+
+// Index of the second order moment of coordinates i <= j.
+int xx(int i, int j) {
+  static const int index[3][3] = {{0, 1, 2}, {1, 3, 4}, {2, 4, 5}};
+  return xx_ + index[i][j];
+}
+
+// Distance of x to the dual sphere or dual plane t.
+double distance(const double *x, std::size_t width, const double *t) {
+  double n2 = t[0] * t[0] + t[1] * t[1] + t[2] * t[2];
+  if (width == 4 || t[3] == 0.0) {
+    double d = width == 4 ? t[3] : t[4];
+    return (x[0] * t[0] + x[1] * t[1] + x[2] * t[2] - d) / std::sqrt(n2);
+  }
+  double dx = x[0] - t[0] / t[3];
+  double dy = x[1] - t[1] / t[3];
+  double dz = x[2] - t[2] / t[3];
+  double r2 = (n2 - 2.0 * t[3] * t[4]) / (t[3] * t[3]);
+  return std::sqrt(dx * dx + dy * dy + dz * dz) -
+         std::sqrt(std::max(r2, 0.0));
+}
+
+} // namespace
+
+fitter::fitter(std::size_t k)
+    : k_(k), seen_(k, false), origins_(3 * k), sums_(k * moments) {
+  if (k == 0) {
+    throw std::invalid_argument("a fitter needs at least one fit");
+  }
+}
+
+void fitter::add(std::size_t n, const double *x, const double *w,
+                 const std::int64_t *labels) {
+  if (n == 0) {
+    return;
+  }
+  if (labels != nullptr) {
+    auto bad = std::find_if(labels, labels + n, [this](std::int64_t l) {
+      return l < 0 || static_cast<std::size_t>(l) >= k_;
+    });
+    if (bad != labels + n) {
+      throw std::out_of_range("fit labels must lie in [0, k)");
+    }
+  }
+  for (std::size_t i = 0; i < n; ++i) {
+    auto f = labels != nullptr ? static_cast<std::size_t>(labels[i]) : 0;
+    if (!seen_[f]) {
+      std::copy(x + 3 * i, x + 3 * i + 3, &origins_[3 * f]);
+      seen_[f] = true;
+    }
+    if (labels == nullptr) {
+      break;
+    }
+  }
+  // Every task keeps the moments of its runs of equal labels, and the runs
+  // are summed in order afterwards so that the result does not depend on the
+  // number of threads.
+  auto kernel = kernels::get().moments;
+  std::vector<std::vector<run>> tasks((n + tile - 1) / tile);
+  parallel_for(n, tile, [&](std::size_t begin, std::size_t end) {
+    auto &runs = tasks[begin / tile];
+    for (auto i = begin; i < end;) {
+      auto j = i + 1;
+      std::int64_t label = 0;
+      if (labels != nullptr) {
+        label = labels[i];
+        while (j < end && labels[j] == label) {
+          ++j;
+        }
+      } else {
+        j = end;
+      }
+      runs.push_back(run{label, {}});
+      kernel(j - i, x + 3 * i, w != nullptr ? w + i : nullptr,
+             &origins_[3 * label], runs.back().sums);
+      i = j;
+    }
+  });
+  for (const auto &runs : tasks) {
+    for (const auto &r : runs) {
+      auto sums = &sums_[r.label * moments];
+      for (std::size_t i = 0; i < moments; ++i) {
+        sums[i] += r.sums[i];
+      }
+    }
+  }
+}
+
+void fitter::reset() {
+  std::fill(sums_.begin(), sums_.end(), 0.0);
+  std::fill(seen_.begin(), seen_.end(), false);
+}
+
+void fitter::weights(double *out) const {
+  for (std::size_t f = 0; f < k_; ++f) {
+    out[f] = sums_[f * moments + w_];
+  }
+}
+
+void fitter::spheres(double *s, double *rms) const {
+  for (std::size_t f = 0; f < k_; ++f, s += 5) {
+    const double *m = &sums_[f * moments];
+    if (!(m[w_] > 0.0)) {
+      std::fill(s, s + 5, nan);
+      rms[f] = nan;
+      continue;
+    }
+    // Moments of the points scaled by 1 / h, with h the root mean square
+    // distance to the origin, so that every entry of A is of order one.
+    double h = std::sqrt(2.0 * m[q_] / m[w_]);
+    if (!(h > 0.0)) {
+      h = 1.0;
+    }
+    double c[5][5];
+    for (int i = 0; i < 3; ++i) {
+      for (int j = i; j < 3; ++j) {
+        c[i][j] = c[j][i] = m[xx(i, j)] / (h * h);
+      }
+      c[i][3] = c[3][i] = m[x_ + i] / h;
+      c[i][4] = c[4][i] = m[qx_ + i] / (h * h * h);
+    }
+    c[3][3] = m[w_];
+    c[3][4] = c[4][3] = m[q_] / (h * h);
+    c[4][4] = m[qq_] / (h * h * h * h);
+    // A = M C M, where M is the identity on e1, e2, e3 and swaps and negates
+    // the origin and infinity coefficients.
+    static const int p[5] = {0, 1, 2, 4, 3};
+    static const double sign[5] = {1.0, 1.0, 1.0, -1.0, -1.0};
+    double a[25];
+    double trace = 0.0;
+    for (int i = 0; i < 5; ++i) {
+      for (int j = 0; j < 5; ++j) {
+        a[i * 5 + j] = sign[i] * sign[j] * c[p[i]][p[j]];
+      }
+      trace += a[i * 5 + i];
+    }
+    // With A = L L^T, A s = l M s becomes B u = u / l for B = L^-1 M L^-T and
+    // u = L^T s. The moments of exact points leave A singular, so its
+    // diagonal is lifted slightly before factoring.
+    double reg[25];
+    std::copy(a, a + 25, reg);
+    for (int i = 0; i < 5; ++i) {
+      reg[i * 5 + i] += 1e-12 * trace;
+    }
+    double l[25];
+    if (!linalg::cholesky(5, reg, l)) {
+      std::fill(s, s + 5, nan);
+      rms[f] = nan;
+      continue;
+    }
+    double inv[25] = {};
+    for (int j = 0; j < 5; ++j) {
+      inv[j * 5 + j] = 1.0 / l[j * 5 + j];
+      for (int i = j + 1; i < 5; ++i) {
+        double sum = 0.0;
+        for (int k = j; k < i; ++k) {
+          sum -= l[i * 5 + k] * inv[k * 5 + j];
+        }
+        inv[i * 5 + j] = sum / l[i * 5 + i];
+      }
+    }
+    static const double metric[25] = {1, 0, 0, 0,  0, 0, 1, 0, 0,  0, 0, 0, 1,
+                                      0, 0, 0, 0, 0, 0, -1, 0, 0, 0, -1, 0};
+    double b[25];
+    for (int i = 0; i < 5; ++i) {
+      for (int j = 0; j < 5; ++j) {
+        double sum = 0.0;
+        for (int k = 0; k < 5; ++k) {
+          for (int r = 0; r < 5; ++r) {
+            sum += inv[i * 5 + k] * metric[k * 5 + r] * inv[j * 5 + r];
+          }
+        }
+        b[i * 5 + j] = sum;
+      }
+    }
+    double v[25];
+    linalg::jacobi(5, b, v);
+    int best = 0;
+    for (int i = 1; i < 5; ++i) {
+      if (b[i * 5 + i] > b[best * 5 + best]) {
+        best = i;
+      }
+    }
+    double e[5];
+    for (int i = 0; i < 5; ++i) {
+      double sum = 0.0;
+      for (int k = i; k < 5; ++k) {
+        sum += inv[k * 5 + i] * v[k * 5 + best];
+      }
+      e[i] = sum;
+    }
+    // Residual on s . s = 1, from the unlifted A.
+    double ss = e[0] * e[0] + e[1] * e[1] + e[2] * e[2] - 2.0 * e[3] * e[4];
+    double ase = 0.0;
+    for (int i = 0; i < 5; ++i) {
+      for (int j = 0; j < 5; ++j) {
+        ase += e[i] * a[i * 5 + j] * e[j];
+      }
+    }
+    rms[f] = h * std::sqrt(std::max(ase / ss, 0.0) / m[w_]);
+    // Undo the scaling, then translate from the origin of the moments.
+    for (int i = 0; i < 3; ++i) {
+      e[i] *= h;
+    }
+    e[4] *= h * h;
+    const double *o = &origins_[3 * f];
+    double eo = e[0] * o[0] + e[1] * o[1] + e[2] * o[2];
+    double oo = o[0] * o[0] + o[1] * o[1] + o[2] * o[2];
+    e[4] += eo + 0.5 * e[3] * oo;
+    for (int i = 0; i < 3; ++i) {
+      e[i] += e[3] * o[i];
+    }
+    double scale = e[3];
+    if (scale == 0.0) {
+      scale = std::sqrt(e[0] * e[0] + e[1] * e[1] + e[2] * e[2]);
+    }
+    for (int i = 0; i < 5; ++i) {
+      s[i] = e[i] / scale;
+    }
+  }
+}
+
+void fitter::planes(double *dlp, double *rms) const {
+  for (std::size_t f = 0; f < k_; ++f, dlp += 4) {
+    const double *m = &sums_[f * moments];
+    if (!(m[w_] > 0.0)) {
+      std::fill(dlp, dlp + 4, nan);
+      rms[f] = nan;
+      continue;
+    }
+    double mean[3];
+    for (int i = 0; i < 3; ++i) {
+      mean[i] = m[x_ + i] / m[w_];
+    }
+    double cov[9];
+    for (int i = 0; i < 3; ++i) {
+      for (int j = 0; j < 3; ++j) {
+        cov[i * 3 + j] =
+            m[xx(std::min(i, j), std::max(i, j))] / m[w_] - mean[i] * mean[j];
+      }
+    }
+    double v[9];
+    linalg::jacobi(3, cov, v);
+    int least = 0;
+    for (int i = 1; i < 3; ++i) {
+      if (cov[i * 3 + i] < cov[least * 3 + least]) {
+        least = i;
+      }
+    }
+    double d = 0.0;
+    for (int i = 0; i < 3; ++i) {
+      dlp[i] = v[i * 3 + least];
+      d += dlp[i] * (mean[i] + origins_[3 * f + i]);
+    }
+    dlp[3] = d;
+    rms[f] = std::sqrt(std::max(cov[least * 3 + least], 0.0));
+  }
+}
+
+void residuals(std::size_t n, const double *x, std::size_t width,
+               const double *targets, std::size_t inc,
+               const std::int64_t *labels, double *out) {
+  parallel_for(n, tile, [&](std::size_t begin, std::size_t end) {
+    for (auto i = begin; i < end; ++i) {
+      auto t = labels != nullptr ? targets + width * labels[i]
+                                 : targets + inc * i;
+      out[i] = distance(x + 3 * i, width, t);
+    }
+  });
+}
+
+} // namespace c3d
+
+} // namespace pyversor
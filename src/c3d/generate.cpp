@@ -75,6 +75,96 @@ void def_generate(py::module &m) {
   });
   generate.def("cayley",
                [](const c3d::dual_line_t &b) { return Gen::cayley(b); });
+  generate.def("boost", [](const c3d::point_pair_t &p) { return Gen::bst(p); });
+  generate.def("dilator", [](const c3d::point_t &p, double t) {
+    return Gen::dil(p, t);
+  });
+
+  generate.def("split_pairs", [](const array_t &pairs) {
+    auto n = batch_size(pairs, 10, "pairs");
+    auto shape = batch_shape(pairs);
+    py::array_t<std::int64_t> count(shape);
+    shape.push_back(2);
+    shape.push_back(10);
+    array_t out(shape);
+    auto src = pairs.data();
+    auto dst = out.mutable_data();
+    auto pc = count.mutable_data();
+    {
+      py::gil_scoped_release release;
+      split_pairs(n, src, dst, pc);
+    }
+    return py::make_tuple(out, count);
+  });
+  generate.def("split_logs", [](const array_t &rotors) {
+    auto n = batch_size(rotors, 16, "rotors");
+    auto shape = batch_shape(rotors);
+    py::array_t<std::int64_t> count(shape);
+    shape.push_back(2);
+    shape.push_back(10);
+    array_t out(shape);
+    auto src = rotors.data();
+    auto dst = out.mutable_data();
+    auto pc = count.mutable_data();
+    {
+      py::gil_scoped_release release;
+      split_logs(n, src, dst, pc);
+    }
+    return py::make_tuple(out, count);
+  });
+
+  py::class_<blend>(generate, "Blend")
+      .def(py::init([](const c3d::conformal_rotor_t &con) {
+             return blend(con.val.data());
+           }),
+           py::arg("con"))
+      .def_static(
+          "from_circles",
+          [](const c3d::circle_t &a, const c3d::circle_t &b, bool flip) {
+            vsr::cga::Cir ca(a);
+            vsr::cga::Cir cb(b);
+            return blend::circles(ca.val.data(), cb.val.data(), flip);
+          },
+          py::arg("a"), py::arg("b"), py::arg("flip") = false)
+      .def("__len__", &blend::size)
+      .def_property_readonly("log",
+                             [](const blend &b) {
+                               std::vector<py::ssize_t> shape = {
+                                   static_cast<py::ssize_t>(b.size()), 10};
+                               return array_t(shape, b.log());
+                             })
+      .def("evaluate",
+           [](const blend &b, const array_t &t) {
+             auto m = static_cast<std::size_t>(t.size());
+             std::vector<py::ssize_t> shape(t.shape(), t.shape() + t.ndim());
+             shape.push_back(16);
+             array_t out(shape);
+             auto pt = t.data();
+             auto po = out.mutable_data();
+             {
+               py::gil_scoped_release release;
+               b.evaluate(m, pt, po);
+             }
+             return out;
+           })
+      .def("apply", [](const blend &b, const array_t &t,
+                       const array_t &points) {
+        auto m = static_cast<std::size_t>(t.size());
+        auto n = batch_size(points, 5, "points");
+        std::vector<py::ssize_t> shape(t.shape(), t.shape() + t.ndim());
+        auto inner = batch_shape(points);
+        shape.insert(shape.end(), inner.begin(), inner.end());
+        shape.push_back(5);
+        array_t out(shape);
+        auto pt = t.data();
+        auto pp = points.data();
+        auto po = out.mutable_data();
+        {
+          py::gil_scoped_release release;
+          b.apply(m, pt, n, pp, po);
+        }
+        return out;
+      });
 }
 
 } // namespace c3d
@@ -0,0 +1,126 @@
+// Copyright (c) 2015, Lars Tingelstad
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of pyversor nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+// Loading of named types from coefficient arrays and the hit points of the
+// meet of a line and a round or flat, shared by the ray casting and the
+// bounding volume hierarchy.
+
+#pragma once
+
+#include <versor/space/cga3D_op.h>
+#include <versor/space/cga3D_round.h>
+#include <versor/space/cga3D_types.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace pyversor {
+
+namespace c3d {
+
+namespace hits {
+
+using namespace vsr::cga;
+
+inline Dll load_dll(const double *p) {
+  return Dll(p[0], p[1], p[2], p[3], p[4], p[5]);
+}
+
+inline Dls load_dls(const double *p) {
+  return Dls(p[0], p[1], p[2], p[3], p[4]);
+}
+
+inline Par load_par(const double *p) {
+  return Par(p[0], p[1], p[2], p[3], p[4], p[5], p[6], p[7], p[8], p[9]);
+}
+
+// A line meets a dual plane in a flat point, which only has components at
+// infinity.
+inline bool is_flat(const Par &pp) {
+  double round = 0.0;
+  double flat = 0.0;
+  for (int i = 0; i < 6; ++i) {
+    round = std::max(round, std::fabs(pp[i]));
+  }
+  for (int i = 6; i < 10; ++i) {
+    flat = std::max(flat, std::fabs(pp[i]));
+  }
+  return round <= FPERROR * flat;
+}
+
+// Normalized points of `pp`, returns false if the pair is imaginary or the
+// flat point is at infinity. Both points of an imaginary pair are its center,
+// the point of the line closest to the target.
+inline bool split_pair(const Par &pp, Pnt &a, Pnt &b) {
+  if (is_flat(pp)) {
+    auto w = pp[9];
+    if (w == 0.0) {
+      return false;
+    }
+    a = Round::null(pp[6] / w, pp[7] / w, pp[8] / w);
+    b = a;
+    return true;
+  }
+  if ((pp <= pp)[0] < 0.0) {
+    a = Round::location(pp);
+    b = a;
+    return false;
+  }
+  auto points = Round::split(pp);
+  a = Round::location(points[0]);
+  b = Round::location(points[1]);
+  return true;
+}
+
+// Start `o` and unit direction `d` of the ray along `l`, which starts at
+// `origin` or, if it is null, at the point of the line closest to the origin.
+inline void ray(const Dll &l, const double *origin, double *o, double *d) {
+  auto dir = Flat::direction(l.undual());
+  auto norm = std::sqrt(dir[0] * dir[0] + dir[1] * dir[1] + dir[2] * dir[2]);
+  for (int c = 0; c < 3; ++c) {
+    d[c] = dir[c] / norm;
+  }
+  if (origin != nullptr) {
+    std::copy(origin, origin + 3, o);
+  } else {
+    auto p = Round::location(Flat::location(l, Ori(1), true));
+    std::copy(p.val.begin(), p.val.begin() + 3, o);
+  }
+}
+
+// Distance from `o` along the unit direction `d` to the point `p`.
+inline double along(const double *o, const double *d, const Pnt &p) {
+  return (p[0] - o[0]) * d[0] + (p[1] - o[1]) * d[1] + (p[2] - o[2]) * d[2];
+}
+
+} // namespace hits
+
+} // namespace c3d
+
+} // namespace pyversor
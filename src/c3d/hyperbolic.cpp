@@ -0,0 +1,371 @@
+// Copyright (c) 2015, Lars Tingelstad
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of pyversor nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#include <pyversor/c3d/hyperbolic.h>
+#include <pyversor/c3d/kernels.h>
+#include <pyversor/parallel.h>
+
+#include <versor/space/cga3D_op.h>
+#include <versor/space/cga3D_types.h>
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+namespace pyversor {
+
+namespace c3d {
+
+namespace hyperbolic {
+
+namespace {
+
+using namespace vsr::cga;
+
+// Elements per task.
+constexpr std::size_t tile = 256;
+
+// Rows and columns of the tiles of a distance matrix.
+constexpr std::size_t rows = 16;
+constexpr std::size_t columns = 512;
+
+// Points per leaf of the kd tree.
+constexpr std::size_t leaf = 8;
+
+// acosh(1 + z), accurate for small z.
+inline double acosh1p(double z) {
+  return std::log1p(z + std::sqrt(z * (z + 2.0)));
+}
+
+// Euclidean location of the point p and one minus its squared norm, as
+// (x, y, z, u).
+inline void locate(const double *p, double *out) {
+  auto w = 1.0 / p[3];
+  out[0] = p[0] * w;
+  out[1] = p[1] * w;
+  out[2] = p[2] * w;
+  out[3] = 1.0 - out[0] * out[0] - out[1] * out[1] - out[2] * out[2];
+}
+
+// Squared euclidean distance between the locations a and b.
+inline double squared(const double *a, const double *b) {
+  auto x = a[0] - b[0];
+  auto y = a[1] - b[1];
+  auto z = a[2] - b[2];
+  return x * x + y * y + z * z;
+}
+
+// Distance between the points a and b.
+inline double between(const double *a, const double *b) {
+  double la[4];
+  double lb[4];
+  locate(a, la);
+  locate(b, lb);
+  return acosh1p(2.0 * squared(la, lb) / (la[3] * lb[3]));
+}
+
+// Construct::hgen of the `n` points a and b and amounts t, zero for
+// coincident points. The line is oriented from b to a, so that the boost moves
+// a towards b.
+void generators(std::size_t n, const double *a, std::size_t a_inc,
+                const double *b, std::size_t b_inc, const double *t,
+                std::size_t t_inc, double *out) {
+  for (std::size_t i = 0; i < n; ++i) {
+    auto x = a + a_inc * i;
+    auto y = b + b_inc * i;
+    auto dst = out + 10 * i;
+    auto d = between(x, y);
+    if (!(d > 0.0)) {
+      std::fill_n(dst, 10, 0.0);
+      continue;
+    }
+    Pnt pa(x[0], x[1], x[2], x[3], x[4]);
+    Pnt pb(y[0], y[1], y[2], y[3], y[4]);
+    Pair par = (EP <= (pb ^ pa ^ EP)).runit() * (d * t[t_inc * i] * .5);
+    std::copy(par.val.begin(), par.val.end(), dst);
+  }
+}
+
+// Locations of the `n` points in p, as columns x, y, z and u of length n.
+std::vector<double> locations(std::size_t n, const double *p) {
+  std::vector<double> out(4 * n);
+  parallel_for(n, tile * 16, [&](std::size_t begin, std::size_t end) {
+    for (auto i = begin; i < end; ++i) {
+      double l[4];
+      locate(p + 5 * i, l);
+      for (std::size_t c = 0; c < 4; ++c) {
+        out[c * n + i] = l[c];
+      }
+    }
+  });
+  return out;
+}
+
+// Node of the kd tree, with the bounding box of the points [begin, end) of the
+// tree order. The first child of an inner node follows it and `right` is the
+// index of the second, which is zero for leaves.
+struct node {
+  double lo[3];
+  double hi[3];
+  std::size_t begin;
+  std::size_t end;
+  std::size_t right;
+};
+
+class tree {
+public:
+  // Tree over the `n` points in p.
+  tree(std::size_t n, const double *p) : id_(n), location_(4 * n) {
+    std::vector<double> l(4 * n);
+    for (std::size_t i = 0; i < n; ++i) {
+      locate(p + 5 * i, l.data() + 4 * i);
+      id_[i] = static_cast<std::int64_t>(i);
+    }
+    build(l, 0, n);
+    for (std::size_t i = 0; i < n; ++i) {
+      std::copy_n(l.data() + 4 * id_[i], 4, location_.data() + 4 * i);
+    }
+  }
+
+  // The `k` nearest points to the location a, other than the point `skip`, by
+  // increasing distance.
+  void query(const double *a, std::int64_t skip, std::size_t k,
+             std::int64_t *index, double *distance,
+             std::vector<std::pair<double, std::int64_t>> &heap,
+             std::vector<std::pair<double, std::size_t>> &stack) const {
+    // Points are ranked by |a - b|^2 / (1 - |b|^2), the distance scaled by the
+    // constant 1 - |a|^2, with ties broken by index.
+    heap.clear();
+    stack.clear();
+    stack.emplace_back(0.0, 0);
+    while (!stack.empty()) {
+      auto top = stack.back();
+      stack.pop_back();
+      if (heap.size() == k && top.first > heap.front().first) {
+        continue;
+      }
+      auto &nd = nodes_[top.second];
+      if (nd.right == 0) {
+        for (auto i = nd.begin; i < nd.end; ++i) {
+          if (id_[i] == skip) {
+            continue;
+          }
+          auto l = location_.data() + 4 * i;
+          auto w = squared(a, l) / l[3];
+          std::pair<double, std::int64_t> c(w, id_[i]);
+          if (heap.size() < k) {
+            heap.push_back(c);
+            std::push_heap(heap.begin(), heap.end());
+          } else if (c < heap.front()) {
+            std::pop_heap(heap.begin(), heap.end());
+            heap.back() = c;
+            std::push_heap(heap.begin(), heap.end());
+          }
+        }
+        continue;
+      }
+      auto first = top.second + 1;
+      auto second = nd.right;
+      auto bf = bound(a, nodes_[first]);
+      auto bs = bound(a, nodes_[second]);
+      if (bf < bs) {
+        std::swap(first, second);
+        std::swap(bf, bs);
+      }
+      stack.emplace_back(bf, first);
+      stack.emplace_back(bs, second);
+    }
+    std::sort_heap(heap.begin(), heap.end());
+    for (std::size_t j = 0; j < k; ++j) {
+      index[j] = heap[j].second;
+      distance[j] = acosh1p(2.0 * heap[j].first / a[3]);
+    }
+  }
+
+private:
+  // Lower bound of the rank of the points in the box of nd.
+  static double bound(const double *a, const node &nd) {
+    double e = 0.0;
+    double r = 0.0;
+    for (std::size_t c = 0; c < 3; ++c) {
+      auto d = std::max(std::max(nd.lo[c] - a[c], a[c] - nd.hi[c]), 0.0);
+      auto o = nd.lo[c] > 0.0 ? nd.lo[c] : nd.hi[c] < 0.0 ? nd.hi[c] : 0.0;
+      e += d * d;
+      r += o * o;
+    }
+    return e / (1.0 - r);
+  }
+
+  // Builds the subtree of the points [begin, end) of id_, splitting at the
+  // median of the longest side of their box.
+  void build(const std::vector<double> &l, std::size_t begin,
+             std::size_t end) {
+    auto at = nodes_.size();
+    nodes_.push_back(node());
+    auto &nd = nodes_[at];
+    std::fill_n(nd.lo, 3, INFINITY);
+    std::fill_n(nd.hi, 3, -INFINITY);
+    for (auto i = begin; i < end; ++i) {
+      auto p = l.data() + 4 * id_[i];
+      for (std::size_t c = 0; c < 3; ++c) {
+        nd.lo[c] = std::min(nd.lo[c], p[c]);
+        nd.hi[c] = std::max(nd.hi[c], p[c]);
+      }
+    }
+    nd.begin = begin;
+    nd.end = end;
+    nd.right = 0;
+    if (end - begin <= leaf) {
+      return;
+    }
+    std::size_t axis = 0;
+    for (std::size_t c = 1; c < 3; ++c) {
+      if (nd.hi[c] - nd.lo[c] > nd.hi[axis] - nd.lo[axis]) {
+        axis = c;
+      }
+    }
+    auto mid = begin + (end - begin) / 2;
+    std::nth_element(id_.begin() + begin, id_.begin() + mid,
+                     id_.begin() + end,
+                     [&](std::int64_t i, std::int64_t j) {
+                       return l[4 * i + axis] < l[4 * j + axis];
+                     });
+    build(l, begin, mid);
+    auto right = nodes_.size();
+    build(l, mid, end);
+    nodes_[at].right = right;
+  }
+
+  std::vector<node> nodes_;
+  std::vector<std::int64_t> id_;
+  std::vector<double> location_;
+};
+
+} // namespace
+
+void normalize(std::size_t n, const double *p, double *out) {
+  parallel_for(n, tile * 16, [&](std::size_t begin, std::size_t end) {
+    for (auto i = begin; i < end; ++i) {
+      auto x = p + 5 * i;
+      // EP <= p
+      auto s = -1.0 / (0.5 * x[3] - x[4]);
+      for (std::size_t c = 0; c < 5; ++c) {
+        out[5 * i + c] = s * x[c];
+      }
+    }
+  });
+}
+
+void distance(std::size_t n, const double *a, std::size_t a_inc,
+              const double *b, std::size_t b_inc, double *out) {
+  parallel_for(n, tile * 16, [&](std::size_t begin, std::size_t end) {
+    for (auto i = begin; i < end; ++i) {
+      out[i] = between(a + a_inc * i, b + b_inc * i);
+    }
+  });
+}
+
+void distances(std::size_t n, const double *a, std::size_t m, const double *b,
+               double *out) {
+  auto lb = locations(m, b);
+  auto x = lb.data();
+  auto y = x + m;
+  auto z = y + m;
+  auto u = z + m;
+  parallel_for(n, rows, [&](std::size_t begin, std::size_t end) {
+    double la[rows][4];
+    for (auto i = begin; i < end; ++i) {
+      locate(a + 5 * i, la[i - begin]);
+    }
+    for (std::size_t c = 0; c < m; c += columns) {
+      auto last = std::min(c + columns, m);
+      for (auto i = begin; i < end; ++i) {
+        auto l = la[i - begin];
+        auto s = 2.0 / l[3];
+        auto row = out + m * i;
+        for (auto j = c; j < last; ++j) {
+          auto dx = l[0] - x[j];
+          auto dy = l[1] - y[j];
+          auto dz = l[2] - z[j];
+          row[j] = acosh1p(s * (dx * dx + dy * dy + dz * dz) / u[j]);
+        }
+      }
+    }
+  });
+}
+
+void generator(std::size_t n, const double *a, std::size_t a_inc,
+               const double *b, std::size_t b_inc, const double *t,
+               std::size_t t_inc, double *out) {
+  parallel_for(n, tile, [&](std::size_t begin, std::size_t end) {
+    generators(end - begin, a + a_inc * begin, a_inc, b + b_inc * begin,
+               b_inc, t + t_inc * begin, t_inc, out + 10 * begin);
+  });
+}
+
+void spin(std::size_t n, const double *a, std::size_t a_inc, const double *b,
+          std::size_t b_inc, const double *t, std::size_t t_inc, double *out) {
+  auto &k = kernels::get();
+  parallel_for(n, tile, [&](std::size_t begin, std::size_t end) {
+    double par[10 * tile];
+    auto count = end - begin;
+    generators(count, a + a_inc * begin, a_inc, b + b_inc * begin, b_inc,
+               t + t_inc * begin, t_inc, par);
+    auto dst = out + 5 * begin;
+    k.boost_spin(count, a + a_inc * begin, a_inc, par, 10, dst);
+    k.normalize(count, dst, dst);
+  });
+}
+
+void neighbours(std::size_t m, const double *q, std::size_t n,
+                const double *p, std::size_t k, bool self,
+                std::int64_t *index, double *distance) {
+  if (k == 0) {
+    return;
+  }
+  tree t(n, p);
+  parallel_for(m, tile / 4, [&](std::size_t begin, std::size_t end) {
+    std::vector<std::pair<double, std::int64_t>> heap;
+    std::vector<std::pair<double, std::size_t>> stack;
+    heap.reserve(k);
+    for (auto i = begin; i < end; ++i) {
+      double l[4];
+      locate(q + 5 * i, l);
+      auto skip = self ? static_cast<std::int64_t>(i) : -1;
+      t.query(l, skip, k, index + k * i, distance + k * i, heap, stack);
+    }
+  });
+}
+
+} // namespace hyperbolic
+
+} // namespace c3d
+
+} // namespace pyversor
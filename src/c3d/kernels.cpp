@@ -0,0 +1,130 @@
+// Copyright (c) 2015, Lars Tingelstad
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of pyversor nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#include <pyversor/c3d/kernels.h>
+
+#include <cstdlib>
+#include <stdexcept>
+
+namespace pyversor {
+
+namespace c3d {
+
+namespace kernels {
+
+namespace baseline {
+extern const table kernel_table;
+}
+#ifdef PYVERSOR_KERNELS_AVX2
+namespace avx2 {
+extern const table kernel_table;
+}
+#endif
+#ifdef PYVERSOR_KERNELS_AVX512
+namespace avx512 {
+extern const table kernel_table;
+}
+#endif
+
+namespace {
+
+// Tables compiled into the module and supported by this CPU, slowest first.
+// The AVX variants are only built with GCC and Clang on x86, see
+// CMakeLists.txt, so the CPUID builtins are available whenever they are.
+std::vector<const table *> supported_tables() {
+  std::vector<const table *> tables{&baseline::kernel_table};
+#if defined(PYVERSOR_KERNELS_AVX2) || defined(PYVERSOR_KERNELS_AVX512)
+  __builtin_cpu_init();
+  const bool has_avx2 =
+      __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif
+#ifdef PYVERSOR_KERNELS_AVX2
+  if (has_avx2) {
+    tables.push_back(&avx2::kernel_table);
+  }
+#endif
+#ifdef PYVERSOR_KERNELS_AVX512
+  if (has_avx2 && __builtin_cpu_supports("avx512f")) {
+    tables.push_back(&avx512::kernel_table);
+  }
+#endif
+  return tables;
+}
+
+const table *find(const std::string &isa) {
+  for (auto t : supported_tables()) {
+    if (isa == t->isa) {
+      return t;
+    }
+  }
+  return nullptr;
+}
+
+// The fastest supported table, unless PYVERSOR_ISA names another supported
+// one. An unsupported override falls back to the default instead of failing
+// the import.
+const table *initial() {
+  if (const char *isa = std::getenv("PYVERSOR_ISA")) {
+    if (auto t = find(isa)) {
+      return t;
+    }
+  }
+  return supported_tables().back();
+}
+
+const table *&selected() {
+  static const table *t = initial();
+  return t;
+}
+
+} // namespace
+
+const table &get() { return *selected(); }
+
+std::vector<std::string> available() {
+  std::vector<std::string> isas;
+  for (auto t : supported_tables()) {
+    isas.push_back(t->isa);
+  }
+  return isas;
+}
+
+void select(const std::string &isa) {
+  auto t = find(isa);
+  if (t == nullptr) {
+    throw std::invalid_argument("Instruction set not available: " + isa);
+  }
+  selected() = t;
+}
+
+} // namespace kernels
+
+} // namespace c3d
+
+} // namespace pyversor
@@ -0,0 +1,815 @@
+// Copyright (c) 2015, Lars Tingelstad
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of pyversor nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+// Body of the batched kernels. This file is included once per instruction set
+// by kernels_<isa>.cpp with PYVERSOR_KERNEL_ISA set to the namespace of that
+// variant, and each of those translation units is compiled with its own
+// target flags.
+//
+// The kernels are written out in closed form on plain double arrays instead
+// of using the versor templates: template instantiations are shared between
+// translation units, so the linker could otherwise pick an AVX-512 copy of a
+// product for the baseline kernels. Everything defined here lives in the
+// per-ISA namespace.
+
+#include <math.h>
+
+#include <pyversor/c3d/kernels.h>
+
+#ifndef PYVERSOR_KERNEL_ISA
+#error "PYVERSOR_KERNEL_ISA must be defined before including kernels_impl.h"
+#endif
+
+#define PYVERSOR_KERNEL_STR_(x) #x
+#define PYVERSOR_KERNEL_STR(x) PYVERSOR_KERNEL_STR_(x)
+
+namespace pyversor {
+
+namespace c3d {
+
+namespace kernels {
+
+namespace PYVERSOR_KERNEL_ISA {
+
+// Same tolerance as FPERROR in versor/util/util.h.
+constexpr double fperror = 0.000001;
+
+inline double sinc(double x) { return fabs(x) <= fperror ? 1.0 : sin(x) / x; }
+
+// Point of euclidean vector x: x + no + 0.5 x^2 ni.
+inline void null(const double *__restrict x, double *__restrict out) {
+  out[0] = x[0];
+  out[1] = x[1];
+  out[2] = x[2];
+  out[3] = 1.0;
+  out[4] = 0.5 * (x[0] * x[0] + x[1] * x[1] + x[2] * x[2]);
+}
+
+inline void normalize(const double *__restrict p, double *__restrict out) {
+  const double s = 1.0 / p[3];
+  for (int i = 0; i < 5; ++i) {
+    out[i] = p[i] * s;
+  }
+}
+
+// Gen::mot without its cut-off. The rotation plane is b[0..2] with dual axis
+// m = (b2, -b1, b0); the translation t = b[3..5] splits into the part along m
+// and the part in the plane, which keeps every coefficient even in |m| so that
+// small angles fall back to their Taylor series instead of a pure translation.
+inline void motor_exp(const double *__restrict b, double *__restrict out) {
+  const double w = b[0] * b[0] + b[1] * b[1] + b[2] * b[2];
+  double cc, s, k;
+  if (w < 0.01) {
+    // cos c, sin c / c and (cos c - sin c / c) / c^2 to O(c^10).
+    cc = 1.0 - w / 2.0 * (1.0 - w / 12.0 * (1.0 - w / 30.0 * (1.0 - w / 56.0)));
+    s = 1.0 - w / 6.0 * (1.0 - w / 20.0 * (1.0 - w / 42.0 * (1.0 - w / 72.0)));
+    k = -1.0 / 3.0 +
+        w / 30.0 * (1.0 - w / 28.0 * (1.0 - w / 54.0 * (1.0 - w / 88.0)));
+  } else {
+    const double c = sqrt(w);
+    cc = cos(c);
+    s = sin(c) / c;
+    k = (cc - s) / w;
+  }
+  const double p = b[2] * b[3] - b[1] * b[4] + b[0] * b[5];
+  const double pk = p * k;
+  out[0] = cc;
+  out[1] = b[0] * s;
+  out[2] = b[1] * s;
+  out[3] = b[2] * s;
+  out[4] = b[3] * s + pk * b[2];
+  out[5] = b[4] * s - pk * b[1];
+  out[6] = b[5] * s + pk * b[0];
+  out[7] = p * s;
+}
+
+// Gen::log, after J. Lasenby et al. The scalar part is clamped to [-1, 1] so
+// that round-off in composed motors does not produce NaNs.
+inline void motor_log(const double *__restrict m, double *__restrict out) {
+  const double m0 = m[0] > 1.0 ? 1.0 : (m[0] < -1.0 ? -1.0 : m[0]);
+  const double ac = acos(m0);
+  const double den = sinc(ac);
+  const double den2 = ac * ac * den;
+  const double b0 = m[1] / den;
+  const double b1 = m[2] / den;
+  const double b2 = m[3] / den;
+  out[0] = b0;
+  out[1] = b1;
+  out[2] = b2;
+  if (fabs(den2) <= fperror) {
+    out[3] = m[4];
+    out[4] = m[5];
+    out[5] = m[6];
+    return;
+  }
+  // direction vector part of tq = b * q
+  const double tq3 = b0 * m[5] + b1 * m[6];
+  const double tq4 = -b0 * m[4] + b2 * m[6];
+  const double tq5 = -b1 * m[4] - b2 * m[5];
+  const double s = -1.0 / den2;
+  // cperp = b * e1235 m[7], cpara = b * tq, both direction vector parts
+  out[3] = (-b2 * m[7] + b0 * tq4 + b1 * tq5) * s;
+  out[4] = (b1 * m[7] - b0 * tq3 + b2 * tq5) * s;
+  out[5] = (-b0 * m[7] - b1 * tq3 - b2 * tq4) * s;
+}
+
+inline void motor_product(const double *__restrict a,
+                          const double *__restrict b, double *__restrict out) {
+  out[0] = a[0] * b[0] - a[1] * b[1] - a[2] * b[2] - a[3] * b[3];
+  out[1] = a[0] * b[1] + a[1] * b[0] - a[2] * b[3] + a[3] * b[2];
+  out[2] = a[0] * b[2] + a[1] * b[3] + a[2] * b[0] - a[3] * b[1];
+  out[3] = a[0] * b[3] - a[1] * b[2] + a[2] * b[1] + a[3] * b[0];
+  out[4] = a[0] * b[4] + a[1] * b[5] + a[2] * b[6] - a[3] * b[7] +
+           a[4] * b[0] - a[5] * b[1] - a[6] * b[2] - a[7] * b[3];
+  out[5] = a[0] * b[5] - a[1] * b[4] + a[2] * b[7] + a[3] * b[6] +
+           a[4] * b[1] + a[5] * b[0] - a[6] * b[3] + a[7] * b[2];
+  out[6] = a[0] * b[6] - a[1] * b[7] - a[2] * b[4] - a[3] * b[5] +
+           a[4] * b[2] + a[5] * b[3] + a[6] * b[0] - a[7] * b[1];
+  out[7] = a[0] * b[7] + a[1] * b[6] - a[2] * b[5] + a[3] * b[4] +
+           a[4] * b[3] - a[5] * b[2] + a[6] * b[1] + a[7] * b[0];
+}
+
+// m p ~m, expanded as t = m p followed by t ~m.
+inline void motor_spin(const double *__restrict p, const double *__restrict m,
+                       double *__restrict out) {
+  double t[16];
+  t[0] = m[0] * p[0] + m[1] * p[1] + m[2] * p[2] - m[4] * p[3];
+  t[1] = m[0] * p[1] - m[1] * p[0] + m[3] * p[2] - m[5] * p[3];
+  t[2] = m[0] * p[2] - m[2] * p[0] - m[3] * p[1] - m[6] * p[3];
+  t[3] = m[0] * p[3];
+  t[4] = m[0] * p[4] - m[4] * p[0] - m[5] * p[1] - m[6] * p[2];
+  t[5] = m[1] * p[2] - m[2] * p[1] + m[3] * p[0] - m[7] * p[3];
+  t[6] = m[1] * p[3];
+  t[7] = m[2] * p[3];
+  t[8] = m[3] * p[3];
+  t[9] = m[1] * p[4] - m[4] * p[1] + m[5] * p[0] - m[7] * p[2];
+  t[10] = m[2] * p[4] - m[4] * p[2] + m[6] * p[0] + m[7] * p[1];
+  t[11] = m[3] * p[4] - m[5] * p[2] + m[6] * p[1] - m[7] * p[0];
+  t[12] = -m[4] * p[3];
+  t[13] = -m[5] * p[3];
+  t[14] = -m[6] * p[3];
+  t[15] = -m[7] * p[3];
+  const double r[8] = {m[0], -m[1], -m[2], -m[3], -m[4], -m[5], -m[6], m[7]};
+  out[0] = t[0] * r[0] - t[1] * r[1] - t[2] * r[2] + t[3] * r[4] -
+           t[5] * r[3] + t[6] * r[5] + t[7] * r[6] - t[8] * r[7];
+  out[1] = t[0] * r[1] + t[1] * r[0] - t[2] * r[3] + t[3] * r[5] +
+           t[5] * r[2] - t[6] * r[4] + t[7] * r[7] + t[8] * r[6];
+  out[2] = t[0] * r[2] + t[1] * r[3] + t[2] * r[0] + t[3] * r[6] -
+           t[5] * r[1] - t[6] * r[7] - t[7] * r[4] - t[8] * r[5];
+  out[3] = t[3] * r[0] - t[6] * r[1] - t[7] * r[2] - t[8] * r[3];
+  out[4] = t[0] * r[4] + t[1] * r[5] + t[2] * r[6] + t[4] * r[0] -
+           t[5] * r[7] - t[9] * r[1] - t[10] * r[2] - t[11] * r[3] +
+           t[12] * r[4] + t[13] * r[5] + t[14] * r[6] - t[15] * r[7];
+}
+
+// Closest motor, m (m ~m)^-1/2. With m ~m = s + t e123inf, which commutes with
+// m, the inverse square root is (1 - t / 2s e123inf) / sqrt(s), and the
+// result satisfies both the rotation and the coupling constraint.
+inline void motor_normalize(const double *__restrict m,
+                            double *__restrict out) {
+  const double s = m[0] * m[0] + m[1] * m[1] + m[2] * m[2] + m[3] * m[3];
+  const double t = 2.0 * (m[0] * m[7] - m[1] * m[6] + m[2] * m[5] -
+                          m[3] * m[4]);
+  const double a = 1.0 / sqrt(s);
+  const double b = -0.5 * a * t / s;
+  out[0] = a * m[0];
+  out[1] = a * m[1];
+  out[2] = a * m[2];
+  out[3] = a * m[3];
+  out[4] = a * m[4] - b * m[3];
+  out[5] = a * m[5] + b * m[2];
+  out[6] = a * m[6] - b * m[1];
+  out[7] = a * m[7] + b * m[0];
+}
+
+// Rotation matrix (3 rows of `row` entries) of the rotor m[0..3], which need
+// not be unit, with the translation -2 (m ~r)[4..6] / |r|^2 of the motor m in
+// the fourth column when `translate` is set. With the quaternion
+// (w, x, y, z) = (m0, -m3, m2, -m1) the matrix is the usual one.
+inline void motor_matrix(const double *__restrict m, bool translate,
+                         std::size_t row, double *__restrict out) {
+  const double w = m[0];
+  const double x = -m[3];
+  const double y = m[2];
+  const double z = -m[1];
+  const double ww = w * w;
+  const double xx = x * x;
+  const double yy = y * y;
+  const double zz = z * z;
+  const double s = 1.0 / (ww + xx + yy + zz);
+  out[0] = (ww + xx - yy - zz) * s;
+  out[1] = 2.0 * (x * y - w * z) * s;
+  out[2] = 2.0 * (x * z + w * y) * s;
+  out[row] = 2.0 * (x * y + w * z) * s;
+  out[row + 1] = (ww - xx + yy - zz) * s;
+  out[row + 2] = 2.0 * (y * z - w * x) * s;
+  out[2 * row] = 2.0 * (x * z - w * y) * s;
+  out[2 * row + 1] = 2.0 * (y * z + w * x) * s;
+  out[2 * row + 2] = (ww - xx - yy + zz) * s;
+  if (translate) {
+    out[3] = -2.0 * (m[4] * m[0] + m[5] * m[1] + m[6] * m[2] + m[7] * m[3]) *
+             s;
+    out[row + 3] =
+        -2.0 * (-m[4] * m[1] + m[5] * m[0] + m[6] * m[3] - m[7] * m[2]) * s;
+    out[2 * row + 3] =
+        -2.0 * (-m[4] * m[2] - m[5] * m[3] + m[6] * m[0] + m[7] * m[1]) * s;
+  }
+}
+
+// Unit rotor of the rotation matrix x (3 rows of `row` entries), followed by
+// the translation part of (1 - t inf / 2) r for the fourth column t when
+// `translate` is set. Shepperd's method: the quaternion is taken from the
+// largest of its four squared components, whose candidates are all computed
+// and selected without branches so that the loop vectorizes. The result is
+// normalized, which absorbs mild non-orthogonality of x, and has w >= 0.
+inline void matrix_motor(const double *__restrict x, std::size_t row,
+                         bool translate, double *__restrict out) {
+  const double r00 = x[0];
+  const double r01 = x[1];
+  const double r02 = x[2];
+  const double r10 = x[row];
+  const double r11 = x[row + 1];
+  const double r12 = x[row + 2];
+  const double r20 = x[2 * row];
+  const double r21 = x[2 * row + 1];
+  const double r22 = x[2 * row + 2];
+  const double t0 = 1.0 + r00 + r11 + r22;
+  const double t1 = 1.0 + r00 - r11 - r22;
+  const double t2 = 1.0 - r00 + r11 - r22;
+  const double t3 = 1.0 - r00 - r11 + r22;
+  const double a = r21 - r12;
+  const double b = r02 - r20;
+  const double c = r10 - r01;
+  const double d = r01 + r10;
+  const double e = r02 + r20;
+  const double f = r12 + r21;
+  const bool p0 = t0 >= t1 && t0 >= t2 && t0 >= t3;
+  const bool p1 = !p0 && t1 >= t2 && t1 >= t3;
+  const bool p2 = !p0 && !p1 && t2 >= t3;
+  double w = p0 ? t0 : (p1 ? a : (p2 ? b : c));
+  double qx = p0 ? a : (p1 ? t1 : (p2 ? d : e));
+  double qy = p0 ? b : (p1 ? d : (p2 ? t2 : f));
+  double qz = p0 ? c : (p1 ? e : (p2 ? f : t3));
+  const double n = w * w + qx * qx + qy * qy + qz * qz;
+  const double s = (w < 0.0 ? -1.0 : 1.0) / sqrt(n);
+  w *= s;
+  qx *= s;
+  qy *= s;
+  qz *= s;
+  out[0] = w;
+  out[1] = -qz;
+  out[2] = qy;
+  out[3] = -qx;
+  if (translate) {
+    const double u0 = -0.5 * x[3];
+    const double u1 = -0.5 * x[row + 3];
+    const double u2 = -0.5 * x[2 * row + 3];
+    out[4] = u0 * out[0] - u1 * out[1] - u2 * out[2];
+    out[5] = u0 * out[1] + u1 * out[0] - u2 * out[3];
+    out[6] = u0 * out[2] + u1 * out[3] + u2 * out[0];
+    out[7] = u0 * out[3] - u1 * out[2] + u2 * out[1];
+  }
+}
+
+// Scalar d = p^2 of the point pair p and the coefficients c and s of
+// Gen::bst(p) = c + s p: cos and sin(a) / a of a = sqrt(-d) for d < 0, and
+// cosh and sinh(a) / a of a = sqrt(d) for d > 0. Both are computed and one
+// is selected, so that loops over pairs stay free of branches.
+inline void boost_terms(const double *__restrict p, double &d, double &c,
+                        double &s) {
+  d = p[9] * p[9] - p[0] * p[0] - p[1] * p[1] - p[2] * p[2] +
+      2.0 * (p[3] * p[6] + p[4] * p[7] + p[5] * p[8]);
+  const double a = sqrt(fabs(d));
+  const bool hyperbolic = d > 0.0;
+  c = hyperbolic ? cosh(a) : cos(a);
+  const double sa = hyperbolic ? sinh(a) : sin(a);
+  // Both sinc and sinhc are 1 + d / 6 to second order.
+  s = a < 1e-4 ? 1.0 + d / 6.0 : sa / a;
+}
+
+// Gen::bst of the point pair p, as the 11 coefficients of boost_t.
+inline void boost(const double *__restrict p, double *__restrict out) {
+  double d;
+  double c;
+  double s;
+  boost_terms(p, d, c, s);
+  out[0] = c;
+  for (int i = 0; i < 10; ++i) {
+    out[1 + i] = s * p[i];
+  }
+}
+
+// Contraction x . p of the conformal vector x onto the point pair p, with
+// x . no = -x[4] and x . ni = -x[3].
+inline void contract(const double *__restrict x, const double *__restrict p,
+                     double *__restrict out) {
+  out[0] = -p[0] * x[1] - p[1] * x[2] + p[3] * x[4] + p[6] * x[3];
+  out[1] = p[0] * x[0] - p[2] * x[2] + p[4] * x[4] + p[7] * x[3];
+  out[2] = p[1] * x[0] + p[2] * x[1] + p[5] * x[4] + p[8] * x[3];
+  out[3] = p[3] * x[0] + p[4] * x[1] + p[5] * x[2] + p[9] * x[3];
+  out[4] = p[6] * x[0] + p[7] * x[1] + p[8] * x[2] - p[9] * x[4];
+}
+
+// B x ~B with B = Gen::bst(p) = c + s p, without forming B. For the blade p,
+// with v = x . p and w = v . p, p x - x p = -2 v and p x p = d x - 2 w, so
+// B x ~B = (c^2 - s^2 d) x - 2 c s v + 2 s^2 w.
+inline void boost_spin(const double *__restrict x, const double *__restrict p,
+                       double *__restrict out) {
+  double d;
+  double c;
+  double s;
+  boost_terms(p, d, c, s);
+  double v[5];
+  double w[5];
+  contract(x, p, v);
+  contract(v, p, w);
+  const double a = c * c - s * s * d;
+  const double b = -2.0 * c * s;
+  const double e = 2.0 * s * s;
+  for (int i = 0; i < 5; ++i) {
+    out[i] = a * x[i] + b * v[i] + e * w[i];
+  }
+}
+
+// Gen::dil(p, t), the dilator by exp(t) about the point p, as the 5
+// coefficients (1, e1inf, e2inf, e3inf, noinf) of the translated dilator.
+inline void dilator(const double *__restrict p, double t,
+                    double *__restrict out) {
+  const double c = cosh(0.5 * t);
+  const double s = sinh(0.5 * t);
+  out[0] = c;
+  out[1] = s * p[0];
+  out[2] = s * p[1];
+  out[3] = s * p[2];
+  out[4] = s;
+}
+
+// D x ~D with D = Gen::dil(p, t), without forming D: a translation by -p,
+// the dilation (x, x0, xinf) -> (x, x0 / k, k xinf) with k = exp(t) and a
+// translation back by p.
+inline void dilate(const double *__restrict x, const double *__restrict p,
+                   double t, double *__restrict out) {
+  const double k = exp(t);
+  const double cc = 0.5 * (p[0] * p[0] + p[1] * p[1] + p[2] * p[2]);
+  const double e0 = x[0] - x[3] * p[0];
+  const double e1 = x[1] - x[3] * p[1];
+  const double e2 = x[2] - x[3] * p[2];
+  const double i1 =
+      x[4] - (p[0] * x[0] + p[1] * x[1] + p[2] * x[2]) + x[3] * cc;
+  const double o = x[3] / k;
+  out[0] = e0 + o * p[0];
+  out[1] = e1 + o * p[1];
+  out[2] = e2 + o * p[2];
+  out[3] = o;
+  out[4] = k * i1 + (p[0] * e0 + p[1] * e1 + p[2] * e2) + o * cc;
+}
+
+// Moments of the points in x, relative to origin, with weights w, or ones if
+// w is null. The inner loop runs over `lanes` points with separate
+// accumulators so that it vectorizes without reassociating the sums.
+template <bool weighted>
+void moments(std::size_t n, const double *__restrict x,
+             const double *__restrict w, const double *__restrict origin,
+             double *__restrict out) {
+  constexpr int lanes = 8;
+  double acc[15][lanes] = {};
+  const double o0 = origin[0];
+  const double o1 = origin[1];
+  const double o2 = origin[2];
+  std::size_t i = 0;
+  auto add = [&](std::size_t j, int l) {
+    const double wj = weighted ? w[j] : 1.0;
+    const double a = x[3 * j] - o0;
+    const double b = x[3 * j + 1] - o1;
+    const double c = x[3 * j + 2] - o2;
+    const double q = 0.5 * (a * a + b * b + c * c);
+    const double wa = wj * a;
+    const double wb = wj * b;
+    const double wc = wj * c;
+    const double wq = wj * q;
+    acc[0][l] += wj;
+    acc[1][l] += wa;
+    acc[2][l] += wb;
+    acc[3][l] += wc;
+    acc[4][l] += wa * a;
+    acc[5][l] += wa * b;
+    acc[6][l] += wa * c;
+    acc[7][l] += wb * b;
+    acc[8][l] += wb * c;
+    acc[9][l] += wc * c;
+    acc[10][l] += wq;
+    acc[11][l] += wq * a;
+    acc[12][l] += wq * b;
+    acc[13][l] += wq * c;
+    acc[14][l] += wq * q;
+  };
+  for (; i + lanes <= n; i += lanes) {
+    for (int l = 0; l < lanes; ++l) {
+      add(i + l, l);
+    }
+  }
+  for (int l = 0; i < n; ++i, ++l) {
+    add(i, l);
+  }
+  for (int k = 0; k < 15; ++k) {
+    double sum = 0.0;
+    for (int l = 0; l < lanes; ++l) {
+      sum += acc[k][l];
+    }
+    out[k] += sum;
+  }
+}
+
+// Cross moments of the pairs in a and b with weights w, or ones if w is null,
+// vectorized over `lanes` pairs like moments.
+template <bool weighted>
+void cross_moments(std::size_t n, const double *__restrict a,
+                   std::size_t a_inc, const double *__restrict b,
+                   std::size_t b_inc, const double *__restrict w,
+                   double *__restrict out) {
+  constexpr int lanes = 8;
+  double acc[16][lanes] = {};
+  std::size_t i = 0;
+  auto add = [&](std::size_t j, int l) {
+    const double wj = weighted ? w[j] : 1.0;
+    const double *x = a + a_inc * j;
+    const double *y = b + b_inc * j;
+    acc[0][l] += wj;
+    for (int r = 0; r < 3; ++r) {
+      const double wx = wj * x[r];
+      acc[1 + r][l] += wx;
+      acc[4 + r][l] += wj * y[r];
+      for (int c = 0; c < 3; ++c) {
+        acc[7 + 3 * r + c][l] += wx * y[c];
+      }
+    }
+  };
+  for (; i + lanes <= n; i += lanes) {
+    for (int l = 0; l < lanes; ++l) {
+      add(i + l, l);
+    }
+  }
+  for (int l = 0; i < n; ++i, ++l) {
+    add(i, l);
+  }
+  for (int k = 0; k < 16; ++k) {
+    double sum = 0.0;
+    for (int l = 0; l < lanes; ++l) {
+      sum += acc[k][l];
+    }
+    out[k] += sum;
+  }
+}
+
+void batch_null(std::size_t n, const double *x, double *out) {
+  for (std::size_t i = 0; i < n; ++i) {
+    null(x + 3 * i, out + 5 * i);
+  }
+}
+
+void batch_normalize(std::size_t n, const double *p, double *out) {
+  for (std::size_t i = 0; i < n; ++i) {
+    normalize(p + 5 * i, out + 5 * i);
+  }
+}
+
+void batch_motor_exp(std::size_t n, const double *dll, double *out) {
+  for (std::size_t i = 0; i < n; ++i) {
+    motor_exp(dll + 6 * i, out + 8 * i);
+  }
+}
+
+void batch_motor_log(std::size_t n, const double *mot, double *out) {
+  for (std::size_t i = 0; i < n; ++i) {
+    motor_log(mot + 8 * i, out + 6 * i);
+  }
+}
+
+void batch_motor_product(std::size_t n, const double *a, std::size_t a_inc,
+                         const double *b, std::size_t b_inc, double *out) {
+  for (std::size_t i = 0; i < n; ++i) {
+    motor_product(a + a_inc * i, b + b_inc * i, out + 8 * i);
+  }
+}
+
+void batch_motor_spin(std::size_t n, const double *p, std::size_t p_inc,
+                      const double *m, std::size_t m_inc, double *out) {
+  for (std::size_t i = 0; i < n; ++i) {
+    motor_spin(p + p_inc * i, m + m_inc * i, out + 5 * i);
+  }
+}
+
+void batch_moments(std::size_t n, const double *x, const double *w,
+                   const double *origin, double *out) {
+  if (w != nullptr) {
+    moments<true>(n, x, w, origin, out);
+  } else {
+    moments<false>(n, x, w, origin, out);
+  }
+}
+
+// Inlier tests of the ransac models on one point, see table::inliers.
+struct sphere_model {
+  static bool inlier(const double *p, double x, double y, double z,
+                     double q) {
+    double d2 = p[4] - 2.0 * (x * p[0] + y * p[1] + z * p[2] - p[3] - q);
+    return (d2 >= p[5]) & (d2 <= p[6]);
+  }
+};
+
+struct plane_model {
+  static bool inlier(const double *p, double x, double y, double z, double) {
+    return fabs(x * p[0] + y * p[1] + z * p[2] - p[3]) <= p[4];
+  }
+};
+
+struct circle_model {
+  static bool inlier(const double *p, double x, double y, double z,
+                     double q) {
+    double d2 = p[4] - 2.0 * (x * p[0] + y * p[1] + z * p[2] - p[3] - q);
+    double h = x * p[5] + y * p[6] + z * p[7] - p[8];
+    // (rho - r)^2 + h^2 <= t^2 for the distance rho from the axis, without
+    // the square root so that the loop vectorizes.
+    double rho2 = d2 - h * h;
+    rho2 = rho2 > 0.0 ? rho2 : 0.0;
+    double a = rho2 + h * h + p[4] - p[10];
+    return (a <= 0.0) | (4.0 * rho2 * p[4] >= a * a);
+  }
+};
+
+struct line_model {
+  static bool inlier(const double *p, double x, double y, double z, double) {
+    double vx = x - p[0];
+    double vy = y - p[1];
+    double vz = z - p[2];
+    double along = vx * p[3] + vy * p[4] + vz * p[5];
+    return vx * vx + vy * vy + vz * vz - along * along <= p[6];
+  }
+};
+
+template <typename M>
+std::size_t inliers(std::size_t n, const double *__restrict x,
+                    const double *__restrict y, const double *__restrict z,
+                    const double *__restrict q, const double *params,
+                    bool *__restrict mask) {
+  double p[11];
+  for (int k = 0; k < 11; ++k) {
+    p[k] = params[k];
+  }
+  std::size_t count = 0;
+  if (mask == nullptr) {
+    for (std::size_t i = 0; i < n; ++i) {
+      count += M::inlier(p, x[i], y[i], z[i], q[i]) ? 1 : 0;
+    }
+  } else {
+    for (std::size_t i = 0; i < n; ++i) {
+      mask[i] = M::inlier(p, x[i], y[i], z[i], q[i]);
+      count += mask[i] ? 1 : 0;
+    }
+  }
+  return count;
+}
+
+std::size_t batch_inliers(int model, std::size_t n, const double *x,
+                          const double *y, const double *z, const double *q,
+                          const double *params, bool *mask) {
+  switch (model) {
+  case 0:
+    return inliers<sphere_model>(n, x, y, z, q, params, mask);
+  case 1:
+    return inliers<plane_model>(n, x, y, z, q, params, mask);
+  case 2:
+    return inliers<circle_model>(n, x, y, z, q, params, mask);
+  default:
+    return inliers<line_model>(n, x, y, z, q, params, mask);
+  }
+}
+
+void batch_cross_moments(std::size_t n, const double *a, std::size_t a_inc,
+                         const double *b, std::size_t b_inc, const double *w,
+                         double *out) {
+  if (w != nullptr) {
+    cross_moments<true>(n, a, a_inc, b, b_inc, w, out);
+  } else {
+    cross_moments<false>(n, a, a_inc, b, b_inc, w, out);
+  }
+}
+
+std::size_t batch_overlaps(std::size_t n, const double *__restrict x,
+                           const double *__restrict y,
+                           const double *__restrict z,
+                           const double *__restrict q,
+                           const double *__restrict r,
+                           const double *__restrict params,
+                           bool *__restrict hit) {
+  const double cx = params[0];
+  const double cy = params[1];
+  const double cz = params[2];
+  const double d = params[3];
+  const double s = params[4];
+  std::size_t count = 0;
+  for (std::size_t i = 0; i < n; ++i) {
+    const double dot = cx * x[i] + cy * y[i] + cz * z[i] - d - q[i];
+    const bool h = dot + s * r[i] >= 0.0;
+    hit[i] = h;
+    count += h ? 1 : 0;
+  }
+  return count;
+}
+
+void batch_motor_normalize(std::size_t n, const double *m, double *out) {
+  for (std::size_t i = 0; i < n; ++i) {
+    motor_normalize(m + 8 * i, out + 8 * i);
+  }
+}
+
+void batch_motor_matrix(std::size_t n, const double *m, std::size_t m_inc,
+                        std::size_t row, double *out, std::size_t out_inc) {
+  const bool translate = m_inc >= 8 && row == 4;
+  if (row == 4 && !translate) {
+    for (std::size_t i = 0; i < n; ++i) {
+      double *o = out + out_inc * i;
+      o[3] = o[7] = o[11] = 0.0;
+    }
+  }
+  if (translate) {
+    for (std::size_t i = 0; i < n; ++i) {
+      motor_matrix(m + m_inc * i, true, 4, out + out_inc * i);
+    }
+  } else {
+    for (std::size_t i = 0; i < n; ++i) {
+      motor_matrix(m + m_inc * i, false, row, out + out_inc * i);
+    }
+  }
+}
+
+void batch_matrix_motor(std::size_t n, const double *x, std::size_t x_inc,
+                        std::size_t row, double *out, std::size_t out_inc) {
+  if (out_inc >= 8 && row == 4) {
+    for (std::size_t i = 0; i < n; ++i) {
+      matrix_motor(x + x_inc * i, 4, true, out + out_inc * i);
+    }
+  } else {
+    for (std::size_t i = 0; i < n; ++i) {
+      matrix_motor(x + x_inc * i, row, false, out + out_inc * i);
+    }
+    for (std::size_t i = 0; out_inc >= 8 && i < n; ++i) {
+      double *o = out + out_inc * i;
+      o[4] = o[5] = o[6] = o[7] = 0.0;
+    }
+  }
+}
+
+void batch_boost(std::size_t n, const double *p, double *out) {
+  for (std::size_t i = 0; i < n; ++i) {
+    boost(p + 10 * i, out + 11 * i);
+  }
+}
+
+void batch_boost_spin(std::size_t n, const double *x, std::size_t x_inc,
+                      const double *p, std::size_t p_inc, double *out) {
+  for (std::size_t i = 0; i < n; ++i) {
+    boost_spin(x + x_inc * i, p + p_inc * i, out + 5 * i);
+  }
+}
+
+void batch_dilator(std::size_t n, const double *p, std::size_t p_inc,
+                   const double *t, std::size_t t_inc, double *out) {
+  for (std::size_t i = 0; i < n; ++i) {
+    dilator(p + p_inc * i, t[t_inc * i], out + 5 * i);
+  }
+}
+
+void batch_dilate(std::size_t n, const double *x, std::size_t x_inc,
+                  const double *p, std::size_t p_inc, const double *t,
+                  std::size_t t_inc, double *out) {
+  for (std::size_t i = 0; i < n; ++i) {
+    dilate(x + x_inc * i, p + p_inc * i, t[t_inc * i], out + 5 * i);
+  }
+}
+
+// Field values of the primitives at one point, see table::field.
+template <bool Inner> struct sphere_field {
+  static double value(const double *p, double x, double y, double z) {
+    double vx = x - p[0];
+    double vy = y - p[1];
+    double vz = z - p[2];
+    double d2 = vx * vx + vy * vy + vz * vz;
+    return Inner ? 0.5 * (d2 - p[3] * p[3]) : sqrt(d2) - p[3];
+  }
+};
+
+template <bool Inner> struct plane_field {
+  static double value(const double *p, double x, double y, double z) {
+    return p[3] - x * p[0] - y * p[1] - z * p[2];
+  }
+};
+
+template <bool Inner> struct line_field {
+  static double value(const double *p, double x, double y, double z) {
+    double vx = x - p[0];
+    double vy = y - p[1];
+    double vz = z - p[2];
+    double along = vx * p[3] + vy * p[4] + vz * p[5];
+    double d2 = vx * vx + vy * vy + vz * vz - along * along;
+    d2 = d2 > 0.0 ? d2 : 0.0;
+    return Inner ? 0.5 * d2 : sqrt(d2);
+  }
+};
+
+template <typename M>
+void field(std::size_t n, const double *__restrict x,
+           const double *__restrict y, const double *__restrict z,
+           const double *params, std::int64_t id, double *__restrict value,
+           std::int64_t *__restrict index) {
+  double p[6];
+  for (int k = 0; k < 6; ++k) {
+    p[k] = params[k];
+  }
+  for (std::size_t i = 0; i < n; ++i) {
+    double v = M::value(p, x[i], y[i], z[i]);
+    bool lower = v < value[i];
+    value[i] = lower ? v : value[i];
+    index[i] = lower ? id : index[i];
+  }
+}
+
+template <bool Inner>
+void field(int model, std::size_t n, const double *x, const double *y,
+           const double *z, const double *params, std::int64_t id,
+           double *value, std::int64_t *index) {
+  switch (model) {
+  case 0:
+    return field<sphere_field<Inner>>(n, x, y, z, params, id, value, index);
+  case 1:
+    return field<plane_field<Inner>>(n, x, y, z, params, id, value, index);
+  default:
+    return field<line_field<Inner>>(n, x, y, z, params, id, value, index);
+  }
+}
+
+void batch_field(int model, bool inner, std::size_t n, const double *x,
+                 const double *y, const double *z, const double *params,
+                 std::int64_t id, double *value, std::int64_t *index) {
+  if (inner) {
+    field<true>(model, n, x, y, z, params, id, value, index);
+  } else {
+    field<false>(model, n, x, y, z, params, id, value, index);
+  }
+}
+
+extern const table kernel_table = {
+    PYVERSOR_KERNEL_STR(PYVERSOR_KERNEL_ISA),
+    &batch_null,
+    &batch_normalize,
+    &batch_motor_exp,
+    &batch_motor_log,
+    &batch_motor_product,
+    &batch_motor_spin,
+    &batch_moments,
+    &batch_inliers,
+    &batch_cross_moments,
+    &batch_overlaps,
+    &batch_motor_normalize,
+    &batch_motor_matrix,
+    &batch_matrix_motor,
+    &batch_boost,
+    &batch_boost_spin,
+    &batch_dilator,
+    &batch_dilate,
+    &batch_field,
+};
+
+} // namespace PYVERSOR_KERNEL_ISA
+
+} // namespace kernels
+
+} // namespace c3d
+
+} // namespace pyversor
@@ -0,0 +1,314 @@
+// Copyright (c) 2015, Lars Tingelstad
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of pyversor nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#include <pyversor/c3d/kinematics.h>
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace pyversor {
+
+namespace c3d {
+
+namespace {
+
+// Number of configurations in theta, checking that it has one value per joint.
+std::size_t configurations(const chain &c, const array_t &theta) {
+  auto joints = static_cast<py::ssize_t>(c.size());
+  if (theta.ndim() < 1 || theta.shape(theta.ndim() - 1) != joints) {
+    throw py::value_error("theta must have shape (..., " +
+                          std::to_string(joints) + ")");
+  }
+  return static_cast<std::size_t>(theta.size() / joints);
+}
+
+} // namespace
+
+void def_kinematics(py::module &m) {
+  auto kinematics = m.def_submodule("kinematics");
+
+  py::class_<chain>(kinematics, "Chain")
+      .def(py::init([](const array_t &axes, py::object home, bool dual) {
+             if (axes.ndim() != 2) {
+               throw py::value_error("axes must have shape (joints, 6)");
+             }
+             auto dll = dual_lines(axes, dual);
+             try {
+               if (home.is_none()) {
+                 return chain(dll.size() / 6, dll.data());
+               }
+               auto h = home.cast<array_t>();
+               if (h.size() != 8) {
+                 throw py::value_error("home must be a single motor (8)");
+               }
+               return chain(dll.size() / 6, dll.data(), h.data());
+             } catch (const std::invalid_argument &e) {
+               throw py::value_error(e.what());
+             }
+           }),
+           py::arg("axes"), py::arg("home") = py::none(),
+           py::arg("dual") = false)
+      .def("__len__", &chain::size)
+      .def_property_readonly("axes",
+                             [](const chain &c) {
+                               std::vector<py::ssize_t> shape = {
+                                   static_cast<py::ssize_t>(c.size()), 6};
+                               return array_t(shape, c.axes());
+                             })
+      .def_property_readonly(
+          "home", [](const chain &c) { return array_t(8, c.home()); })
+      .def(
+          "forward",
+          [](const chain &c, const array_t &theta, bool links) -> py::object {
+            auto joints = static_cast<py::ssize_t>(c.size());
+            auto m = configurations(c, theta);
+            auto shape = batch_shape(theta);
+            shape.push_back(8);
+            array_t end(shape);
+            array_t link;
+            double *pl = nullptr;
+            if (links) {
+              shape.back() = joints;
+              shape.push_back(8);
+              link = array_t(shape);
+              pl = link.mutable_data();
+            }
+            auto pt = theta.data();
+            auto pe = end.mutable_data();
+            {
+              py::gil_scoped_release release;
+              c.forward(m, pt, pl, pe);
+            }
+            if (links) {
+              return py::make_tuple(end, link);
+            }
+            return std::move(end);
+          },
+          py::arg("theta"), py::arg("links") = false)
+      .def("jacobian",
+           [](const chain &c, const array_t &theta) {
+             auto m = configurations(c, theta);
+             auto shape = batch_shape(theta);
+             shape.push_back(static_cast<py::ssize_t>(c.size()));
+             shape.push_back(6);
+             array_t out(shape);
+             auto pt = theta.data();
+             auto po = out.mutable_data();
+             {
+               py::gil_scoped_release release;
+               c.jacobian(m, pt, po);
+             }
+             return out;
+           })
+      .def(
+          "inverse",
+          [](const chain &c, const array_t &targets, py::object theta,
+             double damping, double tolerance, std::size_t max_iterations) {
+            auto m = batch_size(targets, 8, "targets");
+            auto joints = c.size();
+            auto shape = batch_shape(targets);
+            shape.push_back(static_cast<py::ssize_t>(joints));
+            array_t out(shape);
+            auto po = out.mutable_data();
+            if (theta.is_none()) {
+              std::fill(po, po + m * joints, 0.0);
+            } else {
+              auto start = theta.cast<array_t>();
+              auto n = configurations(c, start);
+              if (n != m && n != 1) {
+                throw py::value_error(
+                    "theta must be one configuration or one per target");
+              }
+              for (std::size_t i = 0; i < m; ++i) {
+                auto p = start.data() + (n == 1 ? 0 : i * joints);
+                std::copy(p, p + joints, po + i * joints);
+              }
+            }
+            array_t residual(batch_shape(targets));
+            chain::inverse_options opts;
+            opts.damping = damping;
+            opts.tolerance = tolerance;
+            opts.max_iterations = max_iterations;
+            auto pt = targets.data();
+            auto pr = residual.mutable_data();
+            {
+              py::gil_scoped_release release;
+              c.inverse(m, pt, po, opts, pr, nullptr);
+            }
+            return py::make_tuple(out, residual);
+          },
+          py::arg("targets"), py::arg("theta") = py::none(),
+          py::arg("damping") = 1e-3, py::arg("tolerance") = 1e-10,
+          py::arg("max_iterations") = 100);
+
+  py::class_<spline>(kinematics, "Spline")
+      .def(py::init([](const array_t &motors, const array_t &times,
+                       const std::string &name) {
+             static const std::map<std::string, spline::kind> kinds = {
+                 {"linear", spline::kind::linear},
+                 {"bspline", spline::kind::bspline}};
+             auto it = kinds.find(name);
+             if (it == kinds.end()) {
+               throw py::value_error("kind must be 'linear' or 'bspline'");
+             }
+             if (motors.ndim() != 2 || motors.shape(1) != 8) {
+               throw py::value_error("motors must have shape (n, 8)");
+             }
+             if (times.ndim() != 1 || times.shape(0) != motors.shape(0)) {
+               throw py::value_error("times must have shape (n,)");
+             }
+             try {
+               return spline(it->second, times.size(), motors.data(),
+                             times.data());
+             } catch (const std::invalid_argument &e) {
+               throw py::value_error(e.what());
+             }
+           }),
+           py::arg("motors"), py::arg("times"), py::arg("kind") = "linear")
+      .def("__len__", &spline::size)
+      .def(
+          "evaluate",
+          [](const spline &s, const array_t &t,
+             bool derivatives) -> py::object {
+            auto m = static_cast<std::size_t>(t.size());
+            std::vector<py::ssize_t> shape(t.shape(), t.shape() + t.ndim());
+            shape.push_back(8);
+            array_t out(shape);
+            shape.back() = 6;
+            array_t velocity;
+            array_t acceleration;
+            double *pv = nullptr;
+            double *pa = nullptr;
+            if (derivatives) {
+              velocity = array_t(shape);
+              acceleration = array_t(shape);
+              pv = velocity.mutable_data();
+              pa = acceleration.mutable_data();
+            }
+            auto pt = t.data();
+            auto po = out.mutable_data();
+            {
+              py::gil_scoped_release release;
+              s.evaluate(m, pt, po, pv, pa);
+            }
+            if (derivatives) {
+              return py::make_tuple(out, velocity, acceleration);
+            }
+            return std::move(out);
+          },
+          py::arg("t"), py::arg("derivatives") = false);
+
+  py::class_<rigid_bodies>(kinematics, "RigidBodies")
+      .def(py::init([](const array_t &motors, const array_t &twists,
+                       py::object inertia) {
+             auto n = batch_size(motors, 8, "motors");
+             if (batch_size(twists, 6, "twists") != n) {
+               throw py::value_error("motors and twists must have the same "
+                                     "number of bodies");
+             }
+             try {
+               if (inertia.is_none()) {
+                 return rigid_bodies(n, motors.data(), twists.data());
+               }
+               auto in = inertia.cast<array_t>();
+               if (in.size() == 3) {
+                 std::vector<double> moments(3 * n);
+                 for (std::size_t i = 0; i < n; ++i) {
+                   std::copy(in.data(), in.data() + 3, &moments[3 * i]);
+                 }
+                 return rigid_bodies(n, motors.data(), twists.data(),
+                                     moments.data());
+               }
+               if (batch_size(in, 3, "inertia") != n) {
+                 throw py::value_error("inertia must have shape (3,) or "
+                                       "one row per body");
+               }
+               return rigid_bodies(n, motors.data(), twists.data(),
+                                   in.data());
+             } catch (const std::invalid_argument &e) {
+               throw py::value_error(e.what());
+             }
+           }),
+           py::arg("motors"), py::arg("twists"),
+           py::arg("inertia") = py::none())
+      .def("__len__", &rigid_bodies::size)
+      .def_property_readonly("motors",
+                             [](const rigid_bodies &b) {
+                               std::vector<py::ssize_t> shape = {
+                                   static_cast<py::ssize_t>(b.size()), 8};
+                               return array_t(shape, b.motors());
+                             })
+      .def_property_readonly("twists",
+                             [](const rigid_bodies &b) {
+                               std::vector<py::ssize_t> shape = {
+                                   static_cast<py::ssize_t>(b.size()), 6};
+                               return array_t(shape, b.twists());
+                             })
+      .def_property_readonly("inertia",
+                             [](const rigid_bodies &b) {
+                               std::vector<py::ssize_t> shape = {
+                                   static_cast<py::ssize_t>(b.size()), 3};
+                               return array_t(shape, b.inertia());
+                             })
+      .def(
+          "step",
+          [](rigid_bodies &b, double dt, std::size_t steps,
+             const std::string &name, py::object gravity,
+             std::size_t renormalize) {
+            static const std::map<std::string, rigid_bodies::method>
+                methods = {{"euler", rigid_bodies::method::euler},
+                           {"crouch_grossman",
+                            rigid_bodies::method::crouch_grossman},
+                           {"rk4", rigid_bodies::method::rk4}};
+            auto it = methods.find(name);
+            if (it == methods.end()) {
+              throw py::value_error(
+                  "method must be 'euler', 'crouch_grossman' or 'rk4'");
+            }
+            rigid_bodies::options opts;
+            opts.renormalize = renormalize;
+            if (!gravity.is_none()) {
+              auto g = gravity.cast<array_t>();
+              if (g.size() != 3) {
+                throw py::value_error("gravity must be a vector (3)");
+              }
+              std::copy(g.data(), g.data() + 3, opts.gravity);
+            }
+            py::gil_scoped_release release;
+            b.step(dt, steps, it->second, opts);
+          },
+          py::arg("dt"), py::arg("steps") = 1, py::arg("method") = "rk4",
+          py::arg("gravity") = py::none(), py::arg("renormalize") = 16);
+}
+
+} // namespace c3d
+
+} // namespace pyversor
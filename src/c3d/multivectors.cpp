@@ -42,6 +42,8 @@ void def_vector(py::module &m) {
   def_inner_product<c3d::vector_t, c3d::vector_t>(vec);
   def_inner_product<c3d::vector_t, c3d::bivector_t>(vec);
   def_sandwich_product<c3d::vector_t, c3d::motor_t>(vec);
+  def_sandwich_product<c3d::vector_t, c3d::boost_t>(vec);
+  def_sandwich_product<c3d::vector_t, c3d::dilator_t>(vec);
 }
 
 void def_bivector(py::module &m) {
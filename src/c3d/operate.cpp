@@ -29,14 +29,125 @@
 
 #include <pyversor/c3d/operate.h>
 
+#include <map>
+#include <string>
+#include <vector>
+
 namespace pyversor {
 
 namespace c3d {
 
+namespace {
+
+template <typename T> void def_apply(py::class_<outermorphism> &c) {
+  c.def("apply", [](const outermorphism &o, const T &x) {
+    T out;
+    o.apply(1, x.val.data(), outermorphism::blades<T>(), out.val.data());
+    return out;
+  });
+}
+
+template <typename V> void def_compile(py::module &m) {
+  m.def("compile_outermorphism", [](const V &v) {
+    try {
+      return outermorphism::of(v);
+    } catch (const std::invalid_argument &e) {
+      throw py::value_error(e.what());
+    }
+  });
+}
+
+// Blades of the named types that arrays can hold, by name.
+const std::map<std::string, std::vector<int>> &array_kinds() {
+  static const std::map<std::string, std::vector<int>> kinds = {
+      {"vector", outermorphism::blades<vector_t>()},
+      {"point", outermorphism::blades<point_t>()},
+      {"dual_sphere", outermorphism::blades<dual_sphere_t>()},
+      {"bivector", outermorphism::blades<bivector_t>()},
+      {"point_pair", outermorphism::blades<point_pair_t>()},
+      {"trivector", outermorphism::blades<trivector_t>()},
+      {"circle", outermorphism::blades<circle_t>()},
+      {"quadvector", outermorphism::blades<quadvector_t>()},
+      {"sphere", outermorphism::blades<sphere_t>()},
+      {"dual_line", outermorphism::blades<dual_line_t>()},
+      {"line", outermorphism::blades<line_t>()},
+      {"dual_plane", outermorphism::blades<dual_plane_t>()},
+      {"plane", outermorphism::blades<plane_t>()},
+      {"flat_point", outermorphism::blades<flat_point_t>()},
+      {"motor", outermorphism::blades<motor_t>()},
+      {"multivector", outermorphism::blades<multivector_t>()}};
+  return kinds;
+}
+
+} // namespace
+
 void def_operate(py::module &m) {
   using vsr::cga::Op;
   auto operate = m.def_submodule("operate");
   operate.def("axis_angle", [](const c3d::circle_t &c) { return Op::AA(c); });
+
+  py::class_<outermorphism> om(operate, "Outermorphism");
+  om.def(
+      "grade",
+      [](const outermorphism &o, int k) {
+        if (k < 0 || k > 5) {
+          throw py::value_error("grade must be in [0, 5]");
+        }
+        auto d = static_cast<py::ssize_t>(outermorphism::dimension(k));
+        std::vector<py::ssize_t> shape = {d, d};
+        return array_t(shape, o.grade(k));
+      },
+      py::arg("k"));
+  def_apply<vector_t>(om);
+  def_apply<bivector_t>(om);
+  def_apply<trivector_t>(om);
+  def_apply<quadvector_t>(om);
+  def_apply<pseudoscalar_t>(om);
+  def_apply<dual_line_t>(om);
+  def_apply<line_t>(om);
+  def_apply<dual_plane_t>(om);
+  def_apply<plane_t>(om);
+  def_apply<flat_point_t>(om);
+  def_apply<direction_vector_t>(om);
+  def_apply<direction_bivector_t>(om);
+  def_apply<direction_trivector_t>(om);
+  def_apply<tangent_vector_t>(om);
+  def_apply<tangent_bivector_t>(om);
+  def_apply<tangent_trivector_t>(om);
+  def_apply<motor_t>(om);
+  def_apply<translator_t>(om);
+  def_apply<ega::rotator_t>(om);
+  def_apply<conformal_rotor_t>(om);
+  def_apply<boost_t>(om);
+  def_apply<multivector_t>(om);
+  om.def(
+      "apply",
+      [](const outermorphism &o, const array_t &x, const std::string &kind) {
+        auto it = array_kinds().find(kind);
+        if (it == array_kinds().end()) {
+          throw py::value_error("unknown kind '" + kind + "'");
+        }
+        const auto &blades = it->second;
+        auto num = static_cast<py::ssize_t>(blades.size());
+        auto n = batch_size(x, num, "x");
+        auto out = batch_like(x, num);
+        auto src = x.data();
+        auto dst = out.mutable_data();
+        {
+          py::gil_scoped_release release;
+          o.apply(n, src, blades, dst);
+        }
+        return out;
+      },
+      py::arg("x"), py::arg("kind"));
+
+  def_compile<motor_t>(operate);
+  def_compile<translator_t>(operate);
+  def_compile<ega::rotator_t>(operate);
+  def_compile<conformal_rotor_t>(operate);
+  def_compile<boost_t>(operate);
+  def_compile<vector_t>(operate);
+  def_compile<dual_plane_t>(operate);
 }
 
 } // namespace c3d
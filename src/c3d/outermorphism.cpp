@@ -0,0 +1,182 @@
+// Copyright (c) 2015, Lars Tingelstad
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of pyversor nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#include <pyversor/c3d/outermorphism.h>
+#include <pyversor/parallel.h>
+
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+namespace pyversor {
+
+namespace c3d {
+
+namespace {
+
+// Elements per task.
+constexpr std::size_t tile = 4096;
+
+int grade_of(int blade) {
+  int k = 0;
+  for (; blade; blade >>= 1) {
+    k += blade & 1;
+  }
+  return k;
+}
+
+// Bitmasks of the blades of grade k in ascending order.
+std::vector<int> grade_blades(int k) {
+  std::vector<int> out;
+  for (int b = 0; b < 32; ++b) {
+    if (grade_of(b) == k) {
+      out.push_back(b);
+    }
+  }
+  return out;
+}
+
+// Index of a blade among those of its grade.
+int grade_index(int blade) {
+  int i = 0;
+  for (int b = 0; b < blade; ++b) {
+    i += grade_of(b) == grade_of(blade) ? 1 : 0;
+  }
+  return i;
+}
+
+// Determinant of the k by k row major matrix a, by elimination with partial
+// pivoting.
+double determinant(double *a, int k) {
+  double det = 1.0;
+  for (int c = 0; c < k; ++c) {
+    int p = c;
+    for (int r = c + 1; r < k; ++r) {
+      if (std::abs(a[k * r + c]) > std::abs(a[k * p + c])) {
+        p = r;
+      }
+    }
+    if (a[k * p + c] == 0.0) {
+      return 0.0;
+    }
+    if (p != c) {
+      for (int j = 0; j < k; ++j) {
+        std::swap(a[k * p + j], a[k * c + j]);
+      }
+      det = -det;
+    }
+    det *= a[k * c + c];
+    for (int r = c + 1; r < k; ++r) {
+      double f = a[k * r + c] / a[k * c + c];
+      for (int j = c; j < k; ++j) {
+        a[k * r + j] -= f * a[k * c + j];
+      }
+    }
+  }
+  return det;
+}
+
+} // namespace
+
+outermorphism::outermorphism(const double *vectors, double s) {
+  if (s == 0.0) {
+    throw std::invalid_argument("the versor must have V ~V != 0");
+  }
+  for (int k = 0; k <= 5; ++k) {
+    auto blades = grade_blades(k);
+    const auto d = blades.size();
+    auto &g = grades_[k];
+    g.assign(d * d, 0.0);
+    const double scale = std::pow(s, 1 - k);
+    for (std::size_t r = 0; r < d; ++r) {
+      for (std::size_t c = 0; c < d; ++c) {
+        double minor[25];
+        int i = 0;
+        for (int br = 0; br < 5; ++br) {
+          if (!(blades[r] >> br & 1)) {
+            continue;
+          }
+          int j = 0;
+          for (int bc = 0; bc < 5; ++bc) {
+            if (blades[c] >> bc & 1) {
+              minor[k * i + j++] = vectors[5 * br + bc];
+            }
+          }
+          ++i;
+        }
+        g[d * r + c] = scale * (k == 0 ? 1.0 : determinant(minor, k));
+      }
+    }
+  }
+}
+
+std::size_t outermorphism::dimension(int k) {
+  static const std::size_t dims[6] = {1, 5, 10, 10, 5, 1};
+  return dims[k];
+}
+
+std::vector<double> outermorphism::block(
+    const std::vector<int> &blades) const {
+  const auto num = blades.size();
+  std::vector<double> out(num * num, 0.0);
+  for (std::size_t r = 0; r < num; ++r) {
+    for (std::size_t c = 0; c < num; ++c) {
+      const int k = grade_of(blades[r]);
+      if (grade_of(blades[c]) == k) {
+        out[num * r + c] = grades_[k][dimension(k) * grade_index(blades[r]) +
+                                     grade_index(blades[c])];
+      }
+    }
+  }
+  return out;
+}
+
+void outermorphism::apply(std::size_t n, const double *x,
+                          const std::vector<int> &blades,
+                          double *out) const {
+  const auto num = blades.size();
+  const auto m = block(blades);
+  parallel_for(n, tile, [&](std::size_t begin, std::size_t end) {
+    for (std::size_t e = begin; e < end; ++e) {
+      const double *xe = x + num * e;
+      double *oe = out + num * e;
+      for (std::size_t r = 0; r < num; ++r) {
+        double acc = 0.0;
+        for (std::size_t c = 0; c < num; ++c) {
+          acc += m[num * r + c] * xe[c];
+        }
+        oe[r] = acc;
+      }
+    }
+  });
+}
+
+} // namespace c3d
+
+} // namespace pyversor
@@ -0,0 +1,353 @@
+// Copyright (c) 2015, Lars Tingelstad
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of pyversor nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#include <pyversor/c3d/kernels.h>
+#include <pyversor/c3d/ransac.h>
+#include <pyversor/parallel.h>
+
+#include <versor/space/cga3D_op.h>
+#include <versor/space/cga3D_round.h>
+#include <versor/space/cga3D_types.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace pyversor {
+
+namespace c3d {
+
+namespace ransac {
+
+namespace {
+
+using namespace vsr::cga;
+
+// Points scored between checks for hypotheses that can no longer win, and
+// points per task when writing the mask.
+constexpr std::size_t tile = 16384;
+// Hypotheses in the first round, after which rounds double until they reach
+// round_work point tests, so that the confidence is checked early but large
+// searches do not pay for starting the threads too often.
+constexpr std::size_t min_round = 64;
+constexpr std::size_t round_work = std::size_t(1) << 22;
+
+constexpr double nan = std::numeric_limits<double>::quiet_NaN();
+
+// Random stream of hypothesis g, splitmix64.
+struct stream {
+  std::uint64_t state;
+
+  stream(std::uint64_t seed, std::uint64_t g)
+      : state(seed ^ (g * 0xd1b54a32d192ed03ull)) {}
+
+  std::uint64_t next() {
+    std::uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+  }
+};
+
+// Distinct indices of a minimal sample.
+void draw(stream &rng, std::size_t n, std::size_t k, std::size_t *sample) {
+  for (std::size_t i = 0; i < k; ++i) {
+    bool fresh;
+    do {
+      sample[i] = static_cast<std::size_t>(rng.next() % n);
+      fresh = std::find(sample, sample + i, sample[i]) == sample + i;
+    } while (!fresh);
+  }
+}
+
+// Points centered on the centroid of the cloud, one coordinate per array, and
+// half their squared norm.
+struct cloud {
+  std::size_t n;
+  double center[3];
+  std::vector<double> x, y, z, q;
+
+  Pnt point(std::size_t i) const { return Round::null(x[i], y[i], z[i]); }
+};
+
+bool finite(const double *p, int n) {
+  for (int i = 0; i < n; ++i) {
+    if (!std::isfinite(p[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Parameters of the normalized dual sphere s for table::inliers, false if s
+// is not a real sphere.
+bool sphere_parameters(Dls s, double *p) {
+  s = s / s[3];
+  p[0] = s[0];
+  p[1] = s[1];
+  p[2] = s[2];
+  p[3] = s[4];
+  p[4] = s[0] * s[0] + s[1] * s[1] + s[2] * s[2] - 2.0 * s[4];
+  return finite(p, 5) && p[4] > 0.0;
+}
+
+// Parameters of the unit dual plane of d for table::inliers, false if it has
+// no normal.
+bool plane_parameters(const Dlp &d, double *p) {
+  double norm = std::sqrt(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+  for (int i = 0; i < 4; ++i) {
+    p[i] = d[i] / norm;
+  }
+  return finite(p, 4) && norm > 0.0;
+}
+
+// Scoring parameters of the hypothesis through the sample of centered points.
+bool hypothesis(model m, const cloud &c, const std::size_t *sample, double t,
+                double *p) {
+  switch (m) {
+  case model::sphere: {
+    auto s = Construct::sphere(c.point(sample[0]), c.point(sample[1]),
+                               c.point(sample[2]), c.point(sample[3]));
+    if (!sphere_parameters(s.dual(), p)) {
+      return false;
+    }
+    double r = std::sqrt(p[4]);
+    p[5] = r > t ? (r - t) * (r - t) : 0.0;
+    p[6] = (r + t) * (r + t);
+    return true;
+  }
+  case model::plane: {
+    auto pln = Construct::plane(c.point(sample[0]), c.point(sample[1]),
+                                c.point(sample[2]));
+    if (!plane_parameters(pln.dual(), p)) {
+      return false;
+    }
+    p[4] = t;
+    return true;
+  }
+  case model::circle: {
+    auto cir = Construct::circle(c.point(sample[0]), c.point(sample[1]),
+                                 c.point(sample[2]));
+    if (!sphere_parameters(Round::surround(cir), p) ||
+        !plane_parameters(Round::carrier(cir).dual(), p + 5)) {
+      return false;
+    }
+    p[9] = 0.0;
+    p[10] = t * t;
+    return true;
+  }
+  case model::line: {
+    auto a = sample[0];
+    auto b = sample[1];
+    double u[3] = {c.x[b] - c.x[a], c.y[b] - c.y[a], c.z[b] - c.z[a]};
+    double norm = std::sqrt(u[0] * u[0] + u[1] * u[1] + u[2] * u[2]);
+    if (!(norm > 0.0)) {
+      return false;
+    }
+    p[0] = c.x[a];
+    p[1] = c.y[a];
+    p[2] = c.z[a];
+    for (int i = 0; i < 3; ++i) {
+      p[3 + i] = u[i] / norm;
+    }
+    p[6] = t * t;
+    return true;
+  }
+  }
+  return false;
+}
+
+// Detected element through the sample, in the original coordinates.
+void element(model m, const double *x, const std::size_t *sample,
+             double *out) {
+  Pnt pts[4];
+  for (std::size_t i = 0; i < sample_size(m); ++i) {
+    auto p = x + 3 * sample[i];
+    pts[i] = Round::null(p[0], p[1], p[2]);
+  }
+  switch (m) {
+  case model::sphere: {
+    auto s = Construct::sphere(pts[0], pts[1], pts[2], pts[3]).dual();
+    s = s / s[3];
+    std::copy(s.val.begin(), s.val.end(), out);
+    break;
+  }
+  case model::plane: {
+    auto d = Construct::plane(pts[0], pts[1], pts[2]).dual();
+    d = d / std::sqrt(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+    std::copy(d.val.begin(), d.val.end(), out);
+    break;
+  }
+  case model::circle: {
+    auto cir = Round::normalize(Construct::circle(pts[0], pts[1], pts[2]));
+    std::copy(cir.val.begin(), cir.val.end(), out);
+    break;
+  }
+  case model::line: {
+    auto lin = Construct::line(pts[0], pts[1]);
+    lin = lin / Round::distance(pts[0], pts[1]);
+    std::copy(lin.val.begin(), lin.val.end(), out);
+    break;
+  }
+  }
+}
+
+} // namespace
+
+std::size_t sample_size(model m) {
+  static const std::size_t k[] = {4, 3, 3, 2};
+  return k[static_cast<int>(m)];
+}
+
+std::size_t model_size(model m) {
+  static const std::size_t k[] = {5, 4, 10, 6};
+  return k[static_cast<int>(m)];
+}
+
+result detect(model m, std::size_t n, const double *x, const options &opts,
+              double *out, bool *mask) {
+  const auto k = sample_size(m);
+  if (n < k) {
+    throw std::invalid_argument("too few points for a sample of the model");
+  }
+  auto inliers = kernels::get().inliers;
+
+  cloud c;
+  c.n = n;
+  std::fill(c.center, c.center + 3, 0.0);
+  for (std::size_t i = 0; i < n; ++i) {
+    for (int j = 0; j < 3; ++j) {
+      c.center[j] += x[3 * i + j];
+    }
+  }
+  for (int j = 0; j < 3; ++j) {
+    c.center[j] /= static_cast<double>(n);
+  }
+  c.x.resize(n);
+  c.y.resize(n);
+  c.z.resize(n);
+  c.q.resize(n);
+  parallel_for(n, tile, [&](std::size_t begin, std::size_t end) {
+    for (auto i = begin; i < end; ++i) {
+      c.x[i] = x[3 * i] - c.center[0];
+      c.y[i] = x[3 * i + 1] - c.center[1];
+      c.z[i] = x[3 * i + 2] - c.center[2];
+      c.q[i] = 0.5 * (c.x[i] * c.x[i] + c.y[i] * c.y[i] + c.z[i] * c.z[i]);
+    }
+  });
+
+  const auto max_round = std::max(min_round, round_work / n);
+  auto round = min_round;
+  std::vector<std::size_t> counts;
+  std::vector<std::size_t> samples;
+  std::vector<std::size_t> best_sample(k);
+  std::size_t best = 0;
+  std::size_t iterations = 0;
+  std::size_t needed = opts.max_iterations;
+
+  while (iterations < needed) {
+    const auto first = iterations;
+    const auto count = std::min(round, needed - iterations);
+    round = std::min(2 * round, max_round);
+    counts.resize(count);
+    samples.resize(count * k);
+    parallel_for(count, 1, [&](std::size_t begin, std::size_t end) {
+      for (auto h = begin; h < end; ++h) {
+        stream rng(opts.seed, first + h);
+        auto sample = &samples[h * k];
+        draw(rng, n, k, sample);
+        counts[h] = 0;
+        double p[11];
+        if (!hypothesis(m, c, sample, opts.threshold, p)) {
+          continue;
+        }
+        // Stop scoring once even all remaining points would not beat the best
+        // of the previous rounds, which wins ties by coming first.
+        std::size_t hits = 0;
+        for (std::size_t i = 0; i < n; i += tile) {
+          if (best > 0 && hits + (n - i) <= best) {
+            hits = 0;
+            break;
+          }
+          auto len = std::min(tile, n - i);
+          hits += inliers(static_cast<int>(m), len, &c.x[i], &c.y[i], &c.z[i],
+                          &c.q[i], p, nullptr);
+        }
+        counts[h] = hits;
+      }
+    });
+    for (std::size_t h = 0; h < count; ++h) {
+      if (counts[h] > best) {
+        best = counts[h];
+        std::copy(&samples[h * k], &samples[h * k] + k, best_sample.begin());
+      }
+    }
+    iterations += count;
+    if (best == n) {
+      break;
+    }
+    if (best > 0) {
+      // Draws for a sample of inliers with the given confidence, at the
+      // inlier ratio of the best hypothesis.
+      double ratio = static_cast<double>(best) / static_cast<double>(n);
+      double w = std::pow(ratio, static_cast<double>(k));
+      double draws = std::log(1.0 - opts.confidence) / std::log(1.0 - w);
+      if (std::isfinite(draws) && draws < static_cast<double>(needed)) {
+        needed = std::max(static_cast<std::size_t>(std::ceil(draws)),
+                          std::size_t(1));
+      }
+    }
+  }
+
+  if (best == 0) {
+    std::fill(out, out + model_size(m), nan);
+    if (mask != nullptr) {
+      std::fill(mask, mask + n, false);
+    }
+    return result{0, iterations};
+  }
+  element(m, x, best_sample.data(), out);
+  if (mask != nullptr) {
+    double p[11];
+    hypothesis(m, c, best_sample.data(), opts.threshold, p);
+    parallel_for(n, tile, [&](std::size_t begin, std::size_t end) {
+      inliers(static_cast<int>(m), end - begin, &c.x[begin], &c.y[begin],
+              &c.z[begin], &c.q[begin], p, mask + begin);
+    });
+  }
+  return result{best, iterations};
+}
+
+} // namespace ransac
+
+} // namespace c3d
+
+} // namespace pyversor
@@ -0,0 +1,132 @@
+// Copyright (c) 2015, Lars Tingelstad
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of pyversor nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#include <pyversor/c3d/raycast.h>
+#include <pyversor/parallel.h>
+
+#include "hits.h"
+
+#include <limits>
+
+namespace pyversor {
+
+namespace c3d {
+
+namespace raycast {
+
+namespace {
+
+using namespace hits;
+
+// Lines per task and targets per inner block. A block of targets stays in L1
+// while every line of the task is intersected with it.
+constexpr std::size_t line_tile = 64;
+constexpr std::size_t target_tile = 256;
+// Point pairs per task when splitting.
+constexpr std::size_t pair_tile = 4096;
+
+} // namespace
+
+void dual_lines(std::size_t m, const double *lin, double *dll) {
+  for (std::size_t i = 0; i < m; ++i, lin += 6, dll += 6) {
+    auto l = Lin(lin[0], lin[1], lin[2], lin[3], lin[4], lin[5]).dual();
+    std::copy(l.val.begin(), l.val.end(), dll);
+  }
+}
+
+void meet(std::size_t m, const double *dll, std::size_t n, const double *s,
+          double *out) {
+  parallel_for(m, line_tile, [&](std::size_t begin, std::size_t end) {
+    for (std::size_t j0 = 0; j0 < n; j0 += target_tile) {
+      auto j1 = std::min(j0 + target_tile, n);
+      for (auto i = begin; i < end; ++i) {
+        auto l = load_dll(dll + 6 * i);
+        for (auto j = j0; j < j1; ++j) {
+          auto pp = Construct::meet(l, load_dls(s + 5 * j));
+          std::copy(pp.val.begin(), pp.val.end(), out + 10 * (i * n + j));
+        }
+      }
+    }
+  });
+}
+
+void split(std::size_t n, const double *pp, double *points, bool *real) {
+  parallel_for(n, pair_tile, [&](std::size_t begin, std::size_t end) {
+    for (auto i = begin; i < end; ++i) {
+      Pnt a, b;
+      real[i] = split_pair(load_par(pp + 10 * i), a, b);
+      std::copy(a.val.begin(), a.val.end(), points + 10 * i);
+      std::copy(b.val.begin(), b.val.end(), points + 10 * i + 5);
+    }
+  });
+}
+
+void nearest(std::size_t m, const double *dll, const double *origin,
+             std::size_t n, const double *s, std::int64_t *index,
+             double *distance) {
+  parallel_for(m, line_tile, [&](std::size_t begin, std::size_t end) {
+    Dll lines[line_tile];
+    double start[line_tile][3];
+    double direction[line_tile][3];
+    for (auto i = begin; i < end; ++i) {
+      auto k = i - begin;
+      lines[k] = load_dll(dll + 6 * i);
+      ray(lines[k], origin == nullptr ? nullptr : origin + 3 * i, start[k],
+          direction[k]);
+      index[i] = -1;
+      distance[i] = std::numeric_limits<double>::infinity();
+    }
+    for (std::size_t j0 = 0; j0 < n; j0 += target_tile) {
+      auto j1 = std::min(j0 + target_tile, n);
+      for (auto i = begin; i < end; ++i) {
+        auto k = i - begin;
+        for (auto j = j0; j < j1; ++j) {
+          Pnt hits[2];
+          if (!split_pair(Construct::meet(lines[k], load_dls(s + 5 * j)),
+                          hits[0], hits[1])) {
+            continue;
+          }
+          for (const auto &p : hits) {
+            auto t = along(start[k], direction[k], p);
+            if (t >= 0.0 && t < distance[i]) {
+              distance[i] = t;
+              index[i] = static_cast<std::int64_t>(j);
+            }
+          }
+        }
+      }
+    }
+  });
+}
+
+} // namespace raycast
+
+} // namespace c3d
+
+} // namespace pyversor
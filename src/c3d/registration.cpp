@@ -0,0 +1,287 @@
+// Copyright (c) 2015, Lars Tingelstad
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of pyversor nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#include <pyversor/c3d/kernels.h>
+#include <pyversor/c3d/registration.h>
+#include <pyversor/parallel.h>
+
+#include <versor/space/cga3D_op.h>
+#include <versor/space/cga3D_types.h>
+
+#include "linalg.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace pyversor {
+
+namespace c3d {
+
+namespace registration {
+
+namespace {
+
+using namespace vsr::cga;
+
+// Correspondences per task.
+constexpr std::size_t tile = 4096;
+
+constexpr double nan = std::numeric_limits<double>::quiet_NaN();
+
+// Unit quaternion (w, x, y, z) of the rotation that best takes the directions
+// a onto b, from h = sum w a b^T, as the dominant eigenvector of Horn's
+// symmetric 4 x 4 matrix. The scalar part is made non-negative.
+void rotation(const double *h, double *q) {
+  double xx = h[0], xy = h[1], xz = h[2];
+  double yx = h[3], yy = h[4], yz = h[5];
+  double zx = h[6], zy = h[7], zz = h[8];
+  double n[16] = {xx + yy + zz, yz - zy,      zx - xz,       xy - yx,
+                  yz - zy,      xx - yy - zz, xy + yx,       zx + xz,
+                  zx - xz,      xy + yx,      -xx + yy - zz, yz + zy,
+                  xy - yx,      zx + xz,      yz + zy,       -xx - yy + zz};
+  double v[16];
+  linalg::jacobi(4, n, v);
+  int best = 0;
+  for (int i = 1; i < 4; ++i) {
+    if (n[i * 4 + i] > n[best * 4 + best]) {
+      best = i;
+    }
+  }
+  double sign = v[best] < 0.0 ? -1.0 : 1.0;
+  for (int i = 0; i < 4; ++i) {
+    q[i] = sign * v[i * 4 + best];
+  }
+}
+
+// Row major rotation matrix of the unit quaternion q.
+void matrix(const double *q, double *r) {
+  double w = q[0], x = q[1], y = q[2], z = q[3];
+  r[0] = 1.0 - 2.0 * (y * y + z * z);
+  r[1] = 2.0 * (x * y - w * z);
+  r[2] = 2.0 * (x * z + w * y);
+  r[3] = 2.0 * (x * y + w * z);
+  r[4] = 1.0 - 2.0 * (x * x + z * z);
+  r[5] = 2.0 * (y * z - w * x);
+  r[6] = 2.0 * (x * z - w * y);
+  r[7] = 2.0 * (y * z + w * x);
+  r[8] = 1.0 - 2.0 * (x * x + y * y);
+}
+
+// r s r^T for symmetric s.
+void conjugate(const double *r, const double *s, double *out) {
+  double rs[9];
+  for (int i = 0; i < 3; ++i) {
+    for (int j = 0; j < 3; ++j) {
+      rs[i * 3 + j] = r[i * 3] * s[j] + r[i * 3 + 1] * s[3 + j] +
+                      r[i * 3 + 2] * s[6 + j];
+    }
+  }
+  for (int i = 0; i < 3; ++i) {
+    for (int j = 0; j < 3; ++j) {
+      out[i * 3 + j] = rs[i * 3] * r[j * 3] + rs[i * 3 + 1] * r[j * 3 + 1] +
+                       rs[i * 3 + 2] * r[j * 3 + 2];
+    }
+  }
+}
+
+void apply(const double *r, const double *x, double *out) {
+  for (int i = 0; i < 3; ++i) {
+    out[i] = r[i * 3] * x[0] + r[i * 3 + 1] * x[1] + r[i * 3 + 2] * x[2];
+  }
+}
+
+// Least norm solution of the symmetric system a t = c, a is overwritten.
+void solve(double *a, const double *c, double *t) {
+  double v[9];
+  linalg::jacobi(3, a, v);
+  double largest = std::max({a[0], a[4], a[8], 0.0});
+  std::fill(t, t + 3, 0.0);
+  for (int k = 0; k < 3; ++k) {
+    double e = a[k * 3 + k];
+    if (!(e > 1e-12 * largest)) {
+      continue;
+    }
+    double vc = (v[k] * c[0] + v[3 + k] * c[1] + v[6 + k] * c[2]) / e;
+    for (int i = 0; i < 3; ++i) {
+      t[i] += v[i * 3 + k] * vc;
+    }
+  }
+}
+
+// Vector with components eps_ijk m_jk of the 3 x 3 matrix m, so that the sum
+// of w x y^T maps to the sum of w x ^ y.
+void cross(const double *m, double *out) {
+  out[0] = m[5] - m[7];
+  out[1] = m[6] - m[2];
+  out[2] = m[1] - m[3];
+}
+
+// Unit directions d and moments m of dual lines, 6 coefficients per line.
+void lines(std::size_t n, const double *dll, double *out) {
+  for (std::size_t i = 0; i < n; ++i, dll += 6, out += 6) {
+    double d[3] = {dll[2], -dll[1], dll[0]};
+    double s = 1.0 / std::sqrt(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+    for (int c = 0; c < 3; ++c) {
+      out[c] = d[c] * s;
+      out[3 + c] = dll[3 + c] * s;
+    }
+  }
+}
+
+// Unit normals and offsets of dual planes.
+void planes(std::size_t n, const double *dlp, double *out) {
+  for (std::size_t i = 0; i < n; ++i, dlp += 4, out += 4) {
+    double s =
+        1.0 / std::sqrt(dlp[0] * dlp[0] + dlp[1] * dlp[1] + dlp[2] * dlp[2]);
+    for (int c = 0; c < 4; ++c) {
+      out[c] = dlp[c] * s;
+    }
+  }
+}
+
+} // namespace
+
+std::size_t width(kind k) {
+  static const std::size_t w[] = {3, 6, 4};
+  return w[static_cast<int>(k)];
+}
+
+void motors(kind k, std::size_t problems, std::size_t n, const double *a,
+            const double *b, const double *w, double *out) {
+  const auto cross_moments = kernels::get().cross_moments;
+  const auto c = width(k);
+  const auto grain = std::max<std::size_t>(1, tile / std::max(n, c));
+  parallel_for(problems, grain, [&](std::size_t begin, std::size_t end) {
+    std::vector<double> ea;
+    std::vector<double> eb;
+    if (k != kind::points) {
+      ea.resize(n * c);
+      eb.resize(n * c);
+    }
+    for (auto p = begin; p < end; ++p) {
+      const double *pa = a + p * n * c;
+      const double *pb = b + p * n * c;
+      const double *pw = w != nullptr ? w + p * n : nullptr;
+      double h[16] = {};
+      double q[4];
+      double r[9];
+      double t[3];
+      if (k == kind::points) {
+        cross_moments(n, pa, 3, pb, 3, pw, h);
+        double sum = h[0];
+        for (int i = 0; i < 3; ++i) {
+          for (int j = 0; j < 3; ++j) {
+            h[7 + 3 * i + j] -= h[1 + i] * h[4 + j] / sum;
+          }
+        }
+        rotation(h + 7, q);
+        matrix(q, r);
+        double ca[3] = {h[1] / sum, h[2] / sum, h[3] / sum};
+        apply(r, ca, t);
+        for (int i = 0; i < 3; ++i) {
+          t[i] = h[4 + i] / sum - t[i];
+        }
+      } else if (k == kind::planes) {
+        planes(n, pa, ea.data());
+        planes(n, pb, eb.data());
+        cross_moments(n, ea.data(), 4, eb.data(), 4, pw, h);
+        rotation(h + 7, q);
+        matrix(q, r);
+        // Spinning moves a plane by the translation along its rotated
+        // normal, so R S R^T t = R sum w n (d_b - d_a).
+        double s[16] = {};
+        cross_moments(n, ea.data(), 4, ea.data(), 4, pw, s);
+        double v[3] = {};
+        for (std::size_t i = 0; i < n; ++i) {
+          double wd = (pw != nullptr ? pw[i] : 1.0) *
+                      (eb[4 * i + 3] - ea[4 * i + 3]);
+          for (int j = 0; j < 3; ++j) {
+            v[j] += wd * ea[4 * i + j];
+          }
+        }
+        double m[9];
+        double rv[3];
+        conjugate(r, s + 7, m);
+        apply(r, v, rv);
+        solve(m, rv, t);
+      } else {
+        lines(n, pa, ea.data());
+        lines(n, pb, eb.data());
+        cross_moments(n, ea.data(), 6, eb.data(), 6, pw, h);
+        rotation(h + 7, q);
+        matrix(q, r);
+        // Spinning adds t ^ R d to the moment of a line, so
+        // R (sum w (1 - d d^T)) R^T t = sum w (R d ^ m_b) - R sum w d ^ m_a.
+        double s[16] = {};
+        double g[16] = {};
+        double ka[16] = {};
+        cross_moments(n, ea.data(), 6, ea.data(), 6, pw, s);
+        cross_moments(n, ea.data(), 6, eb.data() + 3, 6, pw, g);
+        cross_moments(n, ea.data(), 6, ea.data() + 3, 6, pw, ka);
+        for (int i = 0; i < 9; ++i) {
+          s[7 + i] = (i % 4 == 0 ? s[0] : 0.0) - s[7 + i];
+        }
+        double rg[9];
+        for (int i = 0; i < 3; ++i) {
+          for (int j = 0; j < 3; ++j) {
+            rg[i * 3 + j] = r[i * 3] * g[7 + j] + r[i * 3 + 1] * g[10 + j] +
+                            r[i * 3 + 2] * g[13 + j];
+          }
+        }
+        double rhs[3];
+        double da[3];
+        double rda[3];
+        cross(rg, rhs);
+        cross(ka + 7, da);
+        apply(r, da, rda);
+        for (int i = 0; i < 3; ++i) {
+          rhs[i] -= rda[i];
+        }
+        double m[9];
+        conjugate(r, s + 7, m);
+        solve(m, rhs, t);
+      }
+      auto o = out + 8 * p;
+      if (!(h[0] > 0.0)) {
+        std::fill(o, o + 8, nan);
+        continue;
+      }
+      Mot mot = Gen::trs(Vec(t[0], t[1], t[2])) * Rot(q[0], -q[3], q[2], -q[1]);
+      std::copy(mot.val.begin(), mot.val.end(), o);
+    }
+  });
+}
+
+} // namespace registration
+
+} // namespace c3d
+
+} // namespace pyversor
@@ -0,0 +1,196 @@
+// Copyright (c) 2015, Lars Tingelstad
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of pyversor nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#include <pyversor/c3d/kernels.h>
+#include <pyversor/c3d/rigid.h>
+#include <pyversor/parallel.h>
+
+#include <versor/space/cga3D_op.h>
+#include <versor/space/cga3D_types.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace pyversor {
+
+namespace c3d {
+
+namespace {
+
+using namespace vsr::cga;
+
+// Bodies per task. Each task advances its bodies through all the steps.
+constexpr std::size_t tile = 64;
+
+Mot load_mot(const double *m) {
+  return Mot(m[0], m[1], m[2], m[3], m[4], m[5], m[6], m[7]);
+}
+
+Dll load_dll(const double *d) {
+  return Dll(d[0], d[1], d[2], d[3], d[4], d[5]);
+}
+
+// Gen::mot through the shared kernel, which has no small-angle cut-off, since
+// the rotation of a single step is often below Gen::mot's.
+Mot motor_exp(const Dll &b) {
+  Mot m;
+  kernels::get().motor_exp(1, b.val.data(), m.val.data());
+  return m;
+}
+
+// Time derivative of the twist v of a body at pose m. In the frame of the
+// body the twist w holds the angular velocity (-2 w2, 2 w1, -2 w0) and the
+// velocity (-2 w3, -2 w4, -2 w5) of the origin, which follow
+// I dw/dt = (I w) x w and dv/dt = v x w + g. The derivative of the body
+// twist is carried back by m, as the twist itself.
+Dll accelerate(const Mot &m, const Dll &v, const double *inertia,
+               const double *gravity) {
+  const Dll b = v.spin(~m);
+  const double w[3] = {-2.0 * b[2], 2.0 * b[1], -2.0 * b[0]};
+  const double u[3] = {-2.0 * b[3], -2.0 * b[4], -2.0 * b[5]};
+  const double l[3] = {inertia[0] * w[0], inertia[1] * w[1],
+                       inertia[2] * w[2]};
+  const double dw[3] = {(l[1] * w[2] - l[2] * w[1]) / inertia[0],
+                        (l[2] * w[0] - l[0] * w[2]) / inertia[1],
+                        (l[0] * w[1] - l[1] * w[0]) / inertia[2]};
+  const Rot r(m[0], m[1], m[2], m[3]);
+  const Vec g = Vec(gravity[0], gravity[1], gravity[2]).spin(~r);
+  const double du[3] = {u[1] * w[2] - u[2] * w[1] + g[0],
+                        u[2] * w[0] - u[0] * w[2] + g[1],
+                        u[0] * w[1] - u[1] * w[0] + g[2]};
+  return Dll(-0.5 * dw[2], 0.5 * dw[1], -0.5 * dw[0], -0.5 * du[0],
+             -0.5 * du[1], -0.5 * du[2])
+      .spin(m);
+}
+
+// One step of the Lie Euler method.
+void euler(double h, Mot &m, Dll &v, const double *inertia,
+           const double *gravity) {
+  const Dll a = accelerate(m, v, inertia, gravity);
+  m = motor_exp(v * h) * m;
+  v = v + a * h;
+}
+
+// One step of the Crouch-Grossman method of order 3, with the coefficients
+// of Crouch and Grossman (1993). The exponentials of a stage act in order.
+void crouch_grossman(double h, Mot &m, Dll &v, const double *inertia,
+                     const double *gravity) {
+  constexpr double a21 = 3.0 / 4.0;
+  constexpr double a31 = 119.0 / 216.0;
+  constexpr double a32 = 17.0 / 108.0;
+  constexpr double b1 = 13.0 / 51.0;
+  constexpr double b2 = -2.0 / 3.0;
+  constexpr double b3 = 24.0 / 17.0;
+  const Dll k1 = v * h;
+  const Dll l1 = accelerate(m, v, inertia, gravity) * h;
+  const Mot e1 = motor_exp(k1 * a21);
+  const Mot m2 = e1 * m;
+  const Dll v2 = v + l1 * a21;
+  const Dll k2 = v2 * h;
+  const Dll l2 = accelerate(m2, v2, inertia, gravity) * h;
+  const Mot m3 = motor_exp(k2 * a32) * motor_exp(k1 * a31) * m;
+  const Dll v3 = v + l1 * a31 + l2 * a32;
+  const Dll k3 = v3 * h;
+  const Dll l3 = accelerate(m3, v3, inertia, gravity) * h;
+  m = motor_exp(k3 * b3) * motor_exp(k2 * b2) * motor_exp(k1 * b1) * m;
+  v = v + l1 * b1 + l2 * b2 + l3 * b3;
+}
+
+// One step of the commutator free method of order 4 of Celledoni,
+// Marthinsen and Owren (2003), whose last stage and update each compose two
+// exponentials.
+void rk4(double h, Mot &m, Dll &v, const double *inertia,
+         const double *gravity) {
+  const Dll k1 = v * h;
+  const Dll l1 = accelerate(m, v, inertia, gravity) * h;
+  const Mot m2 = motor_exp(k1 * 0.5) * m;
+  const Dll v2 = v + l1 * 0.5;
+  const Dll k2 = v2 * h;
+  const Dll l2 = accelerate(m2, v2, inertia, gravity) * h;
+  const Mot m3 = motor_exp(k2 * 0.5) * m;
+  const Dll v3 = v + l2 * 0.5;
+  const Dll k3 = v3 * h;
+  const Dll l3 = accelerate(m3, v3, inertia, gravity) * h;
+  const Mot m4 = motor_exp(k3 - k1 * 0.5) * m2;
+  const Dll v4 = v + l3;
+  const Dll k4 = v4 * h;
+  const Dll l4 = accelerate(m4, v4, inertia, gravity) * h;
+  const Dll first = (k1 * 3.0 + k2 * 2.0 + k3 * 2.0 - k4) * (1.0 / 12.0);
+  const Dll second = (k1 * -1.0 + k2 * 2.0 + k3 * 2.0 + k4 * 3.0) *
+                     (1.0 / 12.0);
+  m = motor_exp(second) * motor_exp(first) * m;
+  v = v + (l1 + l2 * 2.0 + l3 * 2.0 + l4) * (1.0 / 6.0);
+}
+
+} // namespace
+
+rigid_bodies::rigid_bodies(std::size_t n, const double *motors,
+                           const double *twists, const double *inertia)
+    : motors_(motors, motors + 8 * n), twists_(twists, twists + 6 * n),
+      inertia_(3 * n, 1.0) {
+  if (inertia) {
+    for (std::size_t i = 0; i < 3 * n; ++i) {
+      if (!(inertia[i] > 0.0)) {
+        throw std::invalid_argument("moments of inertia must be positive");
+      }
+    }
+    std::copy(inertia, inertia + 3 * n, inertia_.begin());
+  }
+}
+
+void rigid_bodies::step(double h, std::size_t steps, method m,
+                        const options &opts) {
+  using stepper = void (*)(double, Mot &, Dll &, const double *,
+                           const double *);
+  stepper advance = m == method::euler
+                        ? euler
+                        : (m == method::crouch_grossman ? crouch_grossman
+                                                        : rk4);
+  const std::size_t every = opts.renormalize;
+  parallel_for(size(), tile, [&](std::size_t begin, std::size_t end) {
+    for (std::size_t i = begin; i < end; ++i) {
+      Mot mot = load_mot(motors_.data() + 8 * i);
+      Dll twist = load_dll(twists_.data() + 6 * i);
+      const double *inertia = inertia_.data() + 3 * i;
+      for (std::size_t s = 1; s <= steps; ++s) {
+        advance(h, mot, twist, inertia, opts.gravity);
+        if (every > 0 && (since_ + s) % every == 0) {
+          mot = Gen::normalize(mot);
+        }
+      }
+      std::copy(mot.val.begin(), mot.val.end(), motors_.data() + 8 * i);
+      std::copy(twist.val.begin(), twist.val.end(), twists_.data() + 6 * i);
+    }
+  });
+  since_ = every > 0 ? (since_ + steps) % every : 0;
+}
+
+} // namespace c3d
+
+} // namespace pyversor
@@ -0,0 +1,135 @@
+// Copyright (c) 2015, Lars Tingelstad
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of pyversor nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#include <pyversor/c3d/sampling.h>
+#include <pyversor/parallel.h>
+
+#include <versor/space/cga3D_op.h>
+#include <versor/space/cga3D_round.h>
+#include <versor/space/cga3D_types.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace pyversor {
+
+namespace c3d {
+
+namespace sampling {
+
+namespace {
+
+using namespace vsr::cga;
+
+// Samples per task.
+constexpr std::size_t tile = 16384;
+
+std::size_t grain(std::size_t samples) {
+  return std::max<std::size_t>(tile / std::max<std::size_t>(samples, 1), 1);
+}
+
+// Null points o + a c_k + b s_k for the `m` pairs c_k, s_k.
+void emit(const double *o, const double *a, const double *b, std::size_t m,
+          const double *c, const double *s, double *out) {
+  for (std::size_t k = 0; k < m; ++k) {
+    const double x = o[0] + a[0] * c[k] + b[0] * s[k];
+    const double y = o[1] + a[1] * c[k] + b[1] * s[k];
+    const double z = o[2] + a[2] * c[k] + b[2] * s[k];
+    out[5 * k] = x;
+    out[5 * k + 1] = y;
+    out[5 * k + 2] = z;
+    out[5 * k + 3] = 1.0;
+    out[5 * k + 4] = 0.5 * (x * x + y * y + z * z);
+  }
+}
+
+} // namespace
+
+void circle_points(std::size_t n, const double *cir, std::size_t m,
+                   const double *t, double *out) {
+  std::vector<double> c(m), s(m);
+  for (std::size_t k = 0; k < m; ++k) {
+    c[k] = std::cos(t[k]);
+    s[k] = std::sin(t[k]);
+  }
+  parallel_for(n, grain(m), [&](std::size_t begin, std::size_t end) {
+    for (auto i = begin; i < end; ++i) {
+      Cir ci;
+      std::copy(cir + 10 * i, cir + 10 * i + 10, ci.val.begin());
+      auto o = Round::location(ci);
+      auto p0 = Round::location(Round::point(ci, 0.0));
+      auto p1 = Round::location(Round::point(ci, PIOVERTWO));
+      double center[3], a[3], b[3];
+      for (int k = 0; k < 3; ++k) {
+        center[k] = o[k];
+        a[k] = p0[k] - o[k];
+        b[k] = p1[k] - o[k];
+      }
+      emit(center, a, b, m, c.data(), s.data(), out + 5 * m * i);
+    }
+  });
+}
+
+void sphere_points(std::size_t n, const double *dls, std::size_t mu,
+                   const double *theta, std::size_t mv, const double *phi,
+                   double *out) {
+  std::vector<double> ct(mu), st(mu), cp(mv), sp(mv);
+  for (std::size_t k = 0; k < mu; ++k) {
+    ct[k] = std::cos(theta[k]);
+    st[k] = std::sin(theta[k]);
+  }
+  for (std::size_t k = 0; k < mv; ++k) {
+    cp[k] = std::cos(phi[k]);
+    sp[k] = std::sin(phi[k]);
+  }
+  parallel_for(n, grain(mu * mv), [&](std::size_t begin, std::size_t end) {
+    for (auto i = begin; i < end; ++i) {
+      auto p = dls + 5 * i;
+      DualSphere d(p[0], p[1], p[2], p[3], p[4]);
+      auto o = Round::location(d);
+      auto r = Round::radius(d);
+      const double center[3] = {o[0], o[1], o[2]};
+      // Each ring of constant theta is a circle in the plane of the y axis
+      // and the direction (cos theta, 0, -sin theta).
+      for (std::size_t u = 0; u < mu; ++u) {
+        const double a[3] = {r * ct[u], 0.0, -r * st[u]};
+        const double b[3] = {0.0, -r, 0.0};
+        emit(center, a, b, mv, cp.data(), sp.data(),
+             out + 5 * mv * (mu * i + u));
+      }
+    }
+  });
+}
+
+} // namespace sampling
+
+} // namespace c3d
+
+} // namespace pyversor
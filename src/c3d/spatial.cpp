@@ -0,0 +1,289 @@
+// Copyright (c) 2015, Lars Tingelstad
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of pyversor nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#include <pyversor/c3d/spatial.h>
+
+#include <map>
+#include <string>
+
+namespace pyversor {
+
+namespace c3d {
+
+namespace {
+
+// Field measure named `kind`.
+field::measure field_measure(const std::string &kind) {
+  static const std::map<std::string, field::measure> measures = {
+      {"distance", field::measure::distance},
+      {"inner", field::measure::inner}};
+  auto it = measures.find(kind);
+  if (it == measures.end()) {
+    throw py::value_error("kind must be 'distance' or 'inner'");
+  }
+  return it->second;
+}
+
+// Primitives of the optional targets (dual spheres or dual planes) and lines.
+field::primitives field_primitives(const py::object &targets,
+                                   const py::object &lines, bool dual) {
+  array_t s;
+  std::size_t n = 0;
+  if (!targets.is_none()) {
+    s = targets.cast<array_t>();
+    n = batch_size(s, 5, "targets");
+  }
+  std::vector<double> dll;
+  if (!lines.is_none()) {
+    dll = dual_lines(lines.cast<array_t>(), dual);
+  }
+  return field::primitives(n, n == 0 ? nullptr : s.data(), dll.size() / 6,
+                           dll.data());
+}
+
+} // namespace
+
+void def_spatial(py::module &m) {
+  auto spatial = m.def_submodule("spatial");
+
+  py::class_<bvh>(spatial, "BVH")
+      .def_static("from_dual_spheres",
+                  [](const array_t &s) {
+                    auto n = batch_size(s, 5, "dual_spheres");
+                    auto p = s.data();
+                    py::gil_scoped_release release;
+                    return bvh::dual_spheres(n, p);
+                  })
+      .def_static("from_circles",
+                  [](const array_t &cir) {
+                    auto n = batch_size(cir, 10, "circles");
+                    auto p = cir.data();
+                    py::gil_scoped_release release;
+                    return bvh::circles(n, p);
+                  })
+      .def_static("from_pairs",
+                  [](const array_t &par) {
+                    auto n = batch_size(par, 10, "pairs");
+                    auto p = par.data();
+                    py::gil_scoped_release release;
+                    return bvh::pairs(n, p);
+                  })
+      .def_static("from_planes",
+                  [](const array_t &dlp, const array_t &bounds) {
+                    auto n = batch_size(dlp, 4, "dual_planes");
+                    if (batch_size(bounds, 5, "bounds") != n) {
+                      throw py::value_error(
+                          "bounds must have one dual sphere per plane");
+                    }
+                    auto p = dlp.data();
+                    auto b = bounds.data();
+                    py::gil_scoped_release release;
+                    return bvh::planes(n, p, b);
+                  })
+      .def("__len__", &bvh::size)
+      .def(
+          "raycast",
+          [](const bvh &h, const array_t &lines, py::object origins,
+             bool dual) {
+            auto dll = dual_lines(lines, dual);
+            auto m = dll.size() / 6;
+            array_t start;
+            auto o = ray_origins(origins, m, start);
+            auto shape = batch_shape(lines);
+            py::array_t<std::int64_t> index(shape);
+            array_t distance(shape);
+            auto pi = index.mutable_data();
+            auto pd = distance.mutable_data();
+            {
+              py::gil_scoped_release release;
+              h.raycast(m, dll.data(), o, pi, pd);
+            }
+            return py::make_tuple(index, distance);
+          },
+          py::arg("lines"), py::arg("origins") = py::none(),
+          py::arg("dual") = false)
+      .def("overlap",
+           [](const bvh &h, const array_t &s) {
+             auto m = batch_size(s, 5, "dual_spheres");
+             auto p = s.data();
+             std::vector<std::int64_t> offsets;
+             std::vector<std::int64_t> indices;
+             {
+               py::gil_scoped_release release;
+               h.overlap(m, p, offsets, indices);
+             }
+             return py::make_tuple(
+                 py::array_t<std::int64_t>(offsets.size(), offsets.data()),
+                 py::array_t<std::int64_t>(indices.size(), indices.data()));
+           })
+      .def("nearest", [](const bvh &h, const array_t &x) {
+        auto m = batch_size(x, 3, "points");
+        auto shape = batch_shape(x);
+        py::array_t<std::int64_t> index(shape);
+        array_t distance(shape);
+        auto p = x.data();
+        auto pi = index.mutable_data();
+        auto pd = distance.mutable_data();
+        {
+          py::gil_scoped_release release;
+          h.nearest(m, p, pi, pd);
+        }
+        return py::make_tuple(index, distance);
+      });
+
+  spatial.def(
+      "collisions",
+      [](const array_t &s, py::object others) {
+        auto n = batch_size(s, 5, "dual_spheres");
+        std::vector<std::int64_t> first;
+        std::vector<std::int64_t> second;
+        if (others.is_none()) {
+          auto p = s.data();
+          py::gil_scoped_release release;
+          collision::pairs(n, p, first, second);
+        } else {
+          auto b = others.cast<array_t>();
+          auto m = batch_size(b, 5, "others");
+          auto pa = s.data();
+          auto pb = b.data();
+          py::gil_scoped_release release;
+          collision::pairs(n, pa, m, pb, first, second);
+        }
+        return py::make_tuple(
+            py::array_t<std::int64_t>(first.size(), first.data()),
+            py::array_t<std::int64_t>(second.size(), second.data()));
+      },
+      py::arg("dual_spheres"), py::arg("others") = py::none());
+  spatial.def(
+      "hyperbolic_distances",
+      [](const array_t &points, py::object others) {
+        auto b = others.is_none() ? points : others.cast<array_t>();
+        auto n = batch_size(points, 5, "points");
+        auto m = batch_size(b, 5, "others");
+        auto shape = batch_shape(points);
+        auto other_shape = batch_shape(b);
+        shape.insert(shape.end(), other_shape.begin(), other_shape.end());
+        array_t out(shape);
+        auto pa = points.data();
+        auto pb = b.data();
+        auto dst = out.mutable_data();
+        {
+          py::gil_scoped_release release;
+          hyperbolic::distances(n, pa, m, pb, dst);
+        }
+        return out;
+      },
+      py::arg("points"), py::arg("others") = py::none());
+  spatial.def(
+      "hyperbolic_neighbours",
+      [](const array_t &points, std::size_t k, py::object queries) {
+        bool self = queries.is_none();
+        auto q = self ? points : queries.cast<array_t>();
+        auto n = batch_size(points, 5, "points");
+        auto m = batch_size(q, 5, "queries");
+        if (k > (self && n > 0 ? n - 1 : n)) {
+          throw py::value_error("k is larger than the number of neighbours");
+        }
+        auto shape = batch_shape(q);
+        shape.push_back(static_cast<py::ssize_t>(k));
+        py::array_t<std::int64_t> index(shape);
+        array_t distance(shape);
+        auto pp = points.data();
+        auto pq = q.data();
+        auto pi = index.mutable_data();
+        auto pd = distance.mutable_data();
+        {
+          py::gil_scoped_release release;
+          hyperbolic::neighbours(m, pq, n, pp, k, self, pi, pd);
+        }
+        return py::make_tuple(index, distance);
+      },
+      py::arg("points"), py::arg("k"), py::arg("queries") = py::none());
+  spatial.def(
+      "distance_field",
+      [](const array_t &points, py::object targets, py::object lines,
+         bool dual, const std::string &kind) {
+        auto f = field_measure(kind);
+        auto prims = field_primitives(targets, lines, dual);
+        auto m = batch_size(points, 3, "points");
+        auto shape = batch_shape(points);
+        array_t value(shape);
+        py::array_t<std::int64_t> index(shape);
+        auto p = points.data();
+        auto pv = value.mutable_data();
+        auto pi = index.mutable_data();
+        {
+          py::gil_scoped_release release;
+          field::points(m, p, prims, f, pv, pi);
+        }
+        return py::make_tuple(value, index);
+      },
+      py::arg("points"), py::arg("targets") = py::none(),
+      py::arg("lines") = py::none(), py::arg("dual") = false,
+      py::arg("kind") = "distance");
+  spatial.def(
+      "distance_grid",
+      [](const array_t &origin, const array_t &spacing,
+         const std::vector<std::size_t> &shape, py::object targets,
+         py::object lines, bool dual, const std::string &kind) {
+        if (origin.size() != 3) {
+          throw py::value_error("origin must be a vector (3)");
+        }
+        if (spacing.size() != 1 && spacing.size() != 3) {
+          throw py::value_error("spacing must be a scalar or a vector (3)");
+        }
+        if (shape.size() != 3) {
+          throw py::value_error("shape must have 3 sizes");
+        }
+        auto f = field_measure(kind);
+        auto prims = field_primitives(targets, lines, dual);
+        double step[3];
+        for (int a = 0; a < 3; ++a) {
+          step[a] = spacing.data()[spacing.size() == 1 ? 0 : a];
+        }
+        std::vector<py::ssize_t> dims(shape.begin(), shape.end());
+        array_t value(dims);
+        py::array_t<std::int64_t> index(dims);
+        auto o = origin.data();
+        auto pv = value.mutable_data();
+        auto pi = index.mutable_data();
+        {
+          py::gil_scoped_release release;
+          field::grid(o, step, shape.data(), prims, f, pv, pi);
+        }
+        return py::make_tuple(value, index);
+      },
+      py::arg("origin"), py::arg("spacing"), py::arg("shape"),
+      py::arg("targets") = py::none(), py::arg("lines") = py::none(),
+      py::arg("dual") = false, py::arg("kind") = "distance");
+}
+
+} // namespace c3d
+
+} // namespace pyversor
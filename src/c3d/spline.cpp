@@ -0,0 +1,222 @@
+// Copyright (c) 2015, Lars Tingelstad
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of pyversor nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#include <pyversor/c3d/kernels.h>
+#include <pyversor/c3d/spline.h>
+#include <pyversor/parallel.h>
+
+#include <versor/space/cga3D_op.h>
+#include <versor/space/cga3D_types.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace pyversor {
+
+namespace c3d {
+
+namespace {
+
+using namespace vsr::cga;
+
+// Evaluations per task.
+constexpr std::size_t tile = 1024;
+
+Mot load_mot(const double *m) {
+  return Mot(m[0], m[1], m[2], m[3], m[4], m[5], m[6], m[7]);
+}
+
+Dll load_dll(const double *d) {
+  return Dll(d[0], d[1], d[2], d[3], d[4], d[5]);
+}
+
+// Commutator x y - y x of two dual lines.
+Dll commutator(const Dll &x, const Dll &y) {
+  Mot a(0.0, x[0], x[1], x[2], x[3], x[4], x[5], 0.0);
+  Mot b(0.0, y[0], y[1], y[2], y[3], y[4], y[5], 0.0);
+  Mot c = a * b - b * a;
+  return Dll(c[1], c[2], c[3], c[4], c[5], c[6]);
+}
+
+void store(const Dll &d, double *out) {
+  std::copy(d.val.begin(), d.val.end(), out);
+}
+
+// Values and first and second derivatives of the cumulative cubic B-spline
+// basis functions 1 to 3 at u in [0, 1].
+void basis(double u, double *b, double *db, double *ddb) {
+  double u2 = u * u;
+  double u3 = u2 * u;
+  b[0] = (5.0 + 3.0 * u - 3.0 * u2 + u3) / 6.0;
+  b[1] = (1.0 + 3.0 * u + 3.0 * u2 - 2.0 * u3) / 6.0;
+  b[2] = u3 / 6.0;
+  db[0] = 0.5 * (1.0 - u) * (1.0 - u);
+  db[1] = 0.5 * (1.0 + 2.0 * u - 2.0 * u2);
+  db[2] = 0.5 * u2;
+  ddb[0] = u - 1.0;
+  ddb[1] = 1.0 - 2.0 * u;
+  ddb[2] = u;
+}
+
+} // namespace
+
+spline::spline(kind k, std::size_t n, const double *motors,
+               const double *times)
+    : kind_(k), times_(times, times + n) {
+  if (n == 0) {
+    throw std::invalid_argument("a spline needs at least one keyframe");
+  }
+  for (std::size_t i = 1; i < n; ++i) {
+    if (!(times[i] > times[i - 1])) {
+      throw std::invalid_argument("keyframe times must be increasing");
+    }
+  }
+  std::vector<Mot> keys;
+  keys.reserve(n + 2);
+  for (std::size_t i = 0; i < n; ++i) {
+    auto m = load_mot(motors + 8 * i);
+    if (i > 0 && (m * ~keys.back())[0] < 0.0) {
+      m = m * -1.0;
+    }
+    keys.push_back(m);
+  }
+  if (k == kind::bspline) {
+    keys.insert(keys.begin(), keys.front());
+    keys.push_back(keys.back());
+  }
+  for (std::size_t i = 0; i < keys.size(); ++i) {
+    motors_.insert(motors_.end(), keys[i].val.begin(), keys[i].val.end());
+    if (i > 0) {
+      Dll d = Gen::log(keys[i] * ~keys[i - 1]);
+      logs_.insert(logs_.end(), d.val.begin(), d.val.end());
+    }
+  }
+}
+
+void spline::evaluate(std::size_t m, const double *t, double *motors,
+                      double *velocity, double *acceleration) const {
+  const auto &k = kernels::get();
+  const auto n = size();
+  const double first = times_.front();
+  const double last = times_.back();
+  parallel_for(m, tile, [&](std::size_t begin, std::size_t end) {
+    const auto rows = end - begin;
+    std::vector<std::size_t> segment(rows);
+    std::vector<double> param(rows);
+    std::vector<double> scale(rows);
+    for (std::size_t r = 0; r < rows; ++r) {
+      double tr = std::min(std::max(t[begin + r], first), last);
+      // Zero time scale freezes the motion outside the keyframes.
+      bool inside = t[begin + r] >= first && t[begin + r] <= last;
+      if (n == 1) {
+        segment[r] = 0;
+        param[r] = 0.0;
+        scale[r] = 0.0;
+        continue;
+      }
+      auto s = std::upper_bound(times_.begin(), times_.end(), tr);
+      auto seg = std::min<std::size_t>(s - times_.begin() - 1, n - 2);
+      double dt = times_[seg + 1] - times_[seg];
+      segment[r] = seg;
+      param[r] = (tr - times_[seg]) / dt;
+      scale[r] = inside ? 1.0 / dt : 0.0;
+    }
+    std::vector<double> dll(rows * 6);
+    std::vector<double> exps(rows * 8);
+    std::vector<double> acc(rows * 8);
+    std::vector<double> tmp(rows * 8);
+    // Start from the keyframe before the segment and multiply the motors of
+    // the segment on the left.
+    for (std::size_t r = 0; r < rows; ++r) {
+      auto p = &motors_[8 * segment[r]];
+      std::copy(p, p + 8, &acc[8 * r]);
+    }
+    const int terms = n == 1 ? 0 : (kind_ == kind::linear ? 1 : 3);
+    for (int j = 0; j < terms; ++j) {
+      for (std::size_t r = 0; r < rows; ++r) {
+        double w = param[r];
+        if (kind_ == kind::bspline) {
+          double b[3], db[3], ddb[3];
+          basis(param[r], b, db, ddb);
+          w = b[j];
+        }
+        auto l = &logs_[6 * (segment[r] + j)];
+        for (int c = 0; c < 6; ++c) {
+          dll[6 * r + c] = w * l[c];
+        }
+      }
+      k.motor_exp(rows, dll.data(), exps.data());
+      k.motor_product(rows, exps.data(), 8, acc.data(), 8, tmp.data());
+      std::swap(acc, tmp);
+    }
+    if (motors != nullptr) {
+      std::copy(acc.begin(), acc.end(), motors + 8 * begin);
+    }
+    if (velocity == nullptr && acceleration == nullptr) {
+      return;
+    }
+    for (std::size_t r = 0; r < rows; ++r) {
+      Dll v(0, 0, 0, 0, 0, 0);
+      Dll a(0, 0, 0, 0, 0, 0);
+      if (terms == 1) {
+        v = load_dll(&logs_[6 * segment[r]]) * scale[r];
+      } else if (terms == 3) {
+        // V = sum_j b_j' Ad(E_3 ... E_{j+1}) O_j, where each transported
+        // term turns with the velocity of the motors after it.
+        double b[3], db[3], ddb[3];
+        basis(param[r], b, db, ddb);
+        Mot outer(1, 0, 0, 0, 0, 0, 0, 0);
+        Dll vu(0, 0, 0, 0, 0, 0);
+        Dll au(0, 0, 0, 0, 0, 0);
+        for (int j = 2; j >= 0; --j) {
+          Dll l = load_dll(&logs_[6 * (segment[r] + j)]);
+          Dll o = l.spin(outer);
+          au = au + o * ddb[j] + commutator(vu, o * db[j]);
+          vu = vu + o * db[j];
+          const Dll lb = l * b[j];
+          Mot e;
+          k.motor_exp(1, lb.val.data(), e.val.data());
+          outer = outer * e;
+        }
+        v = vu * scale[r];
+        a = au * (scale[r] * scale[r]);
+      }
+      if (velocity != nullptr) {
+        store(v, velocity + 6 * (begin + r));
+      }
+      if (acceleration != nullptr) {
+        store(a, acceleration + 6 * (begin + r));
+      }
+    }
+  });
+}
+
+} // namespace c3d
+
+} // namespace pyversor
@@ -40,6 +40,7 @@ void def_versors(py::module &m) {
   def_motor(versors);
   def_conformal_rotor(versors);
   def_boost(versors);
+  def_dilator(versors);
 }
 
 void def_rotator(py::module &m) {
@@ -66,6 +67,9 @@ void def_motor(py::module &m) {
   def_geometric_product<c3d::motor_t, ega::rotator_t>(mot);
   def_geometric_product<c3d::motor_t, c3d::dual_line_t>(mot);
   def_addition<c3d::motor_t, c3d::dual_line_t>(mot);
+  mot.def("normalize", [](const c3d::motor_t &self) {
+    return vsr::cga::Gen::normalize(self);
+  });
 }
 
 void def_conformal_rotor(py::module &m) {
@@ -78,6 +82,11 @@ void def_boost(py::module &m) {
   def_geometric_product<c3d::boost_t, c3d::boost_t>(bst);
 }
 
+void def_dilator(py::module &m) {
+  auto dil = def_multivector<dilator_t>(m, "Dilator");
+  def_geometric_product<c3d::dilator_t, c3d::dilator_t>(dil);
+}
+
 } // namespace c3d
 
 } // namespace pyversor
@@ -30,6 +30,9 @@
 
 #include "versor/space/cga3D_op.h"
 
+#include <cmath>
+#include <limits>
+
 namespace vsr {
 namespace cga {
 
@@ -197,6 +200,20 @@ Dll Gen::log(const Mot &m) {
   return rq;
 }
 
+/*! Closest Motor, m (m ~m)^-1/2. With m ~m = s + t e123inf, which commutes
+    with m, the inverse square root is (1 - t / 2s e123inf) / sqrt(s)
+    @param Motor m (drifted off the motor manifold)
+*/
+Mot Gen::normalize(const Mot &m) {
+  VSR_PRECISION s = m[0] * m[0] + m[1] * m[1] + m[2] * m[2] + m[3] * m[3];
+  VSR_PRECISION t = 2.0 * (m[0] * m[7] - m[1] * m[6] + m[2] * m[5] -
+                           m[3] * m[4]);
+  VSR_PRECISION a = 1.0 / sqrt(s);
+  VSR_PRECISION b = -0.5 * a * t / s;
+  return Mot(a * m[0], a * m[1], a * m[2], a * m[3], a * m[4] - b * m[3],
+             a * m[5] + b * m[2], a * m[6] - b * m[1], a * m[7] + b * m[0]);
+}
+
 /*! Dual Line Generator of Motor That Twists Dual Line a to Dual Line b;
 
 */
@@ -377,53 +394,59 @@ Con Gen::ratio(const Pair &a, const Pair &b, bool bFlip, float theta) {
          inverse method for ipar below was given by dorst in personal
    correspondance
 */
-vector<Pair> Gen::split(const Pair &par) {
+PairSplit Gen::split(const Pair &par) {
 
   using SqDeriv = decltype(Sphere() + 1);
 
-  vector<Pair> res;
-
-  SqDeriv h2 = par * par;
-  auto hh2 = Sphere(h2).wt();
-  auto ipar = (-Sphere(h2) + h2[0]) / (h2[0] * h2[0] - hh2);
-
-  // scalar ||f||^2
-  auto tmp2 = ((h2 * h2) - (h2 * 2 * h2[0]))[0];
-  auto ff4 = FERROR(tmp2) ? 0 : pow(-tmp2, 1.0 / 4);
-  auto wt = ff4 * ff4;
-  //  cout << par << endl;
-  //  cout << h2 << endl;
-  //  cout << "SPLIT WEIGHT: " << -tmp2 << " " << h2[0] << " " << wt << endl;
-  if (FERROR(wt)) {
-    if (FERROR(h2[0])) {
-      // cout << h2 << endl;
-      //   cout << "no real splitting going on" << endl; //<-- i.e.
-      //   interpolation of null point pairs
-      res.push_back(par);
-      // res.push_back(Par());
-      return res;
-    } else {
-      //  cout << "(adding random value and retrying)" << endl;
-      static Pair dp(.001, .006, .004, .002, .008, .006, .003, .007, .001,
-                     .001);
-      return split(par + dp);
+  // degenerate bivectors that do not square to zero are moved off the
+  // degenerate set by adding a small fixed bivector, a bounded number of times;
+  // if that never works the split fails with two NaN pairs
+  static const Pair dp(.001, .006, .004, .002, .008, .006, .003, .007, .001,
+                       .001);
+  constexpr int maxRetries = 8;
+
+  PairSplit res;
+  Pair p = par;
+
+  for (int retry = 0;; ++retry) {
+    SqDeriv h2 = p * p;
+    auto hh2 = Sphere(h2).wt();
+
+    // scalar ||f||^2
+    auto tmp2 = ((h2 * h2) - (h2 * 2 * h2[0]))[0];
+    auto ff4 = FERROR(tmp2) ? 0 : pow(-tmp2, 1.0 / 4);
+    auto wt = ff4 * ff4;
+
+    if (FERROR(wt)) {
+      if (FERROR(h2[0])) {
+        // no real splitting going on, i.e. interpolation of null point pairs
+        res.push_back(p);
+        return res;
+      }
+      if (retry == maxRetries) {
+        Pair nan;
+        nan.val.fill(std::numeric_limits<VSR_PRECISION>::quiet_NaN());
+        res.push_back(nan);
+        res.push_back(nan);
+        return res;
+      }
+      p += dp;
+      continue;
     }
-  }
-
-  auto iha = ipar * wt;
-  auto fplus = iha + 1;
-  auto fminus = -iha + 1;
 
-  Pair pa = par * fplus * .5;
-  Pair pb = par * fminus * .5;
+    auto ipar = (-Sphere(h2) + h2[0]) / (h2[0] * h2[0] - hh2);
+    auto iha = ipar * wt;
+    auto fplus = iha + 1;
+    auto fminus = -iha + 1;
 
-  res.push_back(pa);
-  res.push_back(pb);
+    res.push_back(p * fplus * .5);
+    res.push_back(p * fminus * .5);
 
-  return res;
+    return res;
+  }
 }
 
-vector<Pair> Gen::split(const Con &rot) {
+PairSplit Gen::split(const Con &rot) {
 
   // 1. Get Exterior Derivative
   Sphere quad(rot); // grade 4 part
@@ -436,9 +459,9 @@ vector<Pair> Gen::split(const Con &rot) {
 }
 
 /*! Split Log of General Conformal Rotor */
-vector<Pair> Gen::log(const Con &rot) {
+PairSplit Gen::log(const Con &rot) {
 
-  vector<Pair> res;
+  PairSplit res;
 
   // 0. Some Terms for later on
   // R^2
@@ -455,6 +478,18 @@ vector<Pair> Gen::log(const Con &rot) {
   // find commuting split of that
   auto v = split(deriv);
 
+  // nilpotent generator: the rotor is <R>(1 + B) with B = <R>2 / <R>; split
+  // only returns a single pair when the derivative squares to zero
+  if (v.size() < 2) {
+    res.push_back(Pair(rot) / rot[0]);
+    return res;
+  }
+
+  // failed split: pass its NaN pairs on rather than a wrong logarithm
+  if (std::isnan(v[0][0])) {
+    return v;
+  }
+
   // get cosh (see p96 of ref)
   auto sp = v[0].wt(); //(v[0]<=v[0])[0];
   auto sm = v[1].wt(); //(v[1]<=v[1])[0];
@@ -470,17 +505,25 @@ vector<Pair> Gen::log(const Con &rot) {
 }
 
 /*! Split Log from a ratio of two Circles */
-vector<Pair> Gen::log(const Circle &ca, const Circle &cb, bool bFlip,
-                      VSR_PRECISION theta) {
+PairSplit Gen::log(const Circle &ca, const Circle &cb, bool bFlip,
+                   VSR_PRECISION theta) {
   return log(ratio(ca, cb, bFlip, theta));
 }
 /*! Split Log from a ratio of two Circles */
-vector<Pair> Gen::log(const Pair &ca, const Pair &cb, bool bFlip,
-                      VSR_PRECISION theta) {
+PairSplit Gen::log(const Pair &ca, const Pair &cb, bool bFlip,
+                   VSR_PRECISION theta) {
   return log(ratio(ca, cb, bFlip, theta));
 }
 
 /*! General Conformal Transformation from a split log*/
+Con Gen::con(const PairSplit &log, VSR_PRECISION amt) {
+  Con con(1);
+  for (auto &i : log) {
+    con *= Gen::bst(i * -amt);
+  }
+  return con;
+}
+
 Con Gen::con(const vector<Pair> &log, VSR_PRECISION amt) {
   Con con(1);
   for (auto &i : log) {
@@ -490,6 +533,14 @@ Con Gen::con(const vector<Pair> &log, VSR_PRECISION amt) {
 }
 
 /*! General Conformal Transformation from a split log*/
+Con Gen::con(const PairSplit &log, VSR_PRECISION amtA, VSR_PRECISION amtB) {
+  Con tmp = Gen::bst(log[0] * -amtA);
+  if (log.size() > 1) {
+    tmp *= Gen::bst(log[1] * -amtB);
+  }
+  return tmp;
+}
+
 Con Gen::con(const vector<Pair> &log, VSR_PRECISION amtA, VSR_PRECISION amtB) {
   Con tmp = Gen::bst(log[0] * -amtA);
   if (log.size() > 1) {
@@ -601,6 +652,11 @@ Point Construct::point(const DualPlane &dlp, const Point &p) {
 /*-----------------------------------------------------------------------------
  *  CIRCLES
  *-----------------------------------------------------------------------------*/
+/// Circle through three points
+Circle Construct::circle(const Point &a, const Point &b, const Point &c) {
+  return a ^ b ^ c;
+}
+
 /*!
  *  \brief  Circle at origin in plane of bivector B
  */
@@ -635,6 +691,11 @@ Circle Construct::sline(const Point &a, const Point &b) { return a ^ b ^ EM; }
 /*-----------------------------------------------------------------------------
  *  SPHERES
  *-----------------------------------------------------------------------------*/
+/// Sphere through four points
+Sphere Construct::sphere(const Pnt &a, const Pnt &b, const Pnt &c,
+                         const Pnt &d) {
+  return a ^ b ^ c ^ d;
+}
 /// Sphere at x,y,z with radius r (default r=1.0)
 DualSphere Construct::sphere(VSR_PRECISION x, VSR_PRECISION y, VSR_PRECISION z,
                              VSR_PRECISION r) {
@@ -758,6 +819,14 @@ Par Construct::meet(const Cir &cir, const Dls &s) {
   return ((cir).dual() ^ s).dual();
 }
 
+// point pair intersection of line and Dual sphere
+Par Construct::meet(const Line &lin, const Dls &s) {
+  return ((lin).dual() ^ s).dual();
+}
+
+// point pair intersection of dual line and Dual sphere
+Par Construct::meet(const Dll &dll, const Dls &s) { return (dll ^ s).dual(); }
+
 #pragma mark HIT_TESTS
 
 /*!
@@ -813,7 +882,7 @@ double Construct::hdist(const Pnt &pa, const Pnt &pb) {
  */
 Pair Construct::hgen(const Pnt &pa, const Pnt &pb, double amt) {
   double dist = hdist(pa, pb);             //<-- h distance
-  auto hline = pa ^ pb ^ EP;               //<-- h line (circle)
+  auto hline = pb ^ pa ^ EP;               //<-- h line (circle), pb to pa
   auto par_versor = (EP <= hline).runit(); //<-- h trans generator (pair)
   // par_versor /= par_versor.rnorm();   //<-- normalized ...
   return par_versor * dist * amt * .5; //<-- and ready to be applied
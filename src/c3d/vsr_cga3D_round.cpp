@@ -137,12 +137,12 @@ VSR_PRECISION Round::distance(const Point &a, const Point b) {
 }
 
 // Split Points from Point Pair
-std::vector<Point> Round::split(const Pair &pp) {
+std::array<Point, 2> Round::split(const Pair &pp) {
   return vsr::nga::Round::split(pp);
 }
 
 // Split Points from Point Pair and normalize
-std::vector<Point> Round::splitLocation(const Pair &pp) {
+std::array<Point, 2> Round::splitLocation(const Pair &pp) {
   return vsr::nga::Round::splitLocation(pp);
 }
 
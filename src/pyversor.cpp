@@ -29,15 +29,75 @@
 
 #include <pyversor/pyversor.h>
 
+#include <map>
+
 namespace pyversor {
 
+namespace {
+
+struct lazy_submodule {
+  void (*def)(py::module &);
+  bool loaded;
+};
+
+std::map<std::string, lazy_submodule> &lazy_submodules() {
+  static std::map<std::string, lazy_submodule> submodules;
+  return submodules;
+}
+
+} // namespace
+
+void def_lazy_submodule(py::module &m, const std::string &name,
+                        void (*def)(py::module &)) {
+  lazy_submodules()[name] = lazy_submodule{def, false};
+  auto sub = m.def_submodule(name.c_str());
+  // PEP 562 module __getattr__: only called for attributes that are not
+  // registered yet. Dunder lookups done by the import machinery must not
+  // trigger a load.
+  sub.def("__getattr__", [m, name](const std::string &attr) mutable {
+    if (attr.size() > 4 && attr.compare(0, 2, "__") == 0 &&
+        attr.compare(attr.size() - 2, 2, "__") == 0) {
+      PyErr_SetString(PyExc_AttributeError, attr.c_str());
+      throw py::error_already_set();
+    }
+    load_submodule(m, name);
+    return py::object(m.attr(name.c_str()).attr(attr.c_str()));
+  });
+}
+
+void load_submodule(py::module &m, const std::string &name) {
+  auto it = lazy_submodules().find(name);
+  if (it == lazy_submodules().end()) {
+    throw py::value_error("Unknown submodule: " + name);
+  }
+  if (it->second.loaded) {
+    return;
+  }
+  // Mark the submodule as loaded first so that lookups made while defining it
+  // do not recurse, and undo that if defining it fails so that the error is
+  // raised again on the next access rather than leaving it half defined.
+  py::object sub = m.attr(name.c_str());
+  py::object getattr = sub.attr("__getattr__");
+  it->second.loaded = true;
+  py::delattr(sub, "__getattr__");
+  try {
+    it->second.def(m);
+  } catch (...) {
+    it->second.loaded = false;
+    py::setattr(sub, "__getattr__", getattr);
+    throw;
+  }
+}
+
 PYBIND11_MODULE(__pyversor__, m) {
   // ega::add_submodule(m);
-  e3d::def_submodule(m);
-  c3d::def_submodule(m);
-  e41::def_submodule(m);
-  c2d::def_submodule(m);
-  sta::def_submodule(m);
+  def_lazy_submodule(m, "e3d", &e3d::def_submodule);
+  def_lazy_submodule(m, "c3d", &c3d::def_submodule);
+  def_lazy_submodule(m, "e41", &e41::def_submodule);
+  def_lazy_submodule(m, "c2d", &c2d::def_submodule);
+  def_lazy_submodule(m, "sta", &sta::def_submodule);
+  m.def("load_submodule",
+        [m](const std::string &name) mutable { load_submodule(m, name); });
 }
 
 } // namespace pyversor
@@ -0,0 +1,82 @@
+// Copyright (c) 2015, Lars Tingelstad
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of pyversor nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+// Uses the installed headers and library: the versor generators, a batched
+// kernel and a bvh, whose factories refuse more primitives than node indices
+// can hold before they read or allocate anything.
+
+#include <pyversor/c3d/bvh.h>
+#include <pyversor/c3d/kernels.h>
+#include <versor/space/cga3D_op.h>
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <stdexcept>
+
+int main() {
+  using namespace vsr::cga;
+  namespace c3d = pyversor::c3d;
+
+  const double dll[6] = {0.1, -0.2, 0.3, 1.0, 2.0, -0.5};
+  double batched[8];
+  c3d::kernels::get().motor_exp(1, dll, batched);
+  auto m = Gen::mot(Dll(dll[0], dll[1], dll[2], dll[3], dll[4], dll[5]));
+  for (int i = 0; i < 8; ++i) {
+    if (std::fabs(m[i] - batched[i]) > 1e-12) {
+      std::printf("motor_exp does not match Gen::mot\n");
+      return 1;
+    }
+  }
+
+  auto s = Round::dls(Vec(0, 0, 0), 1.0);
+  auto tree = c3d::bvh::dual_spheres(1, s.val.data());
+  const double origin[3] = {-5, 0, 0};
+  const double ray[6] = {0, 0, 1, 0, 0, 0};
+  std::int64_t index;
+  double distance;
+  tree.raycast(1, ray, origin, &index, &distance);
+  if (index != 0 || std::fabs(distance - 4.0) > 1e-12) {
+    std::printf("bvh raycast missed the unit sphere\n");
+    return 1;
+  }
+
+  const auto too_many =
+      static_cast<std::size_t>(std::numeric_limits<std::int32_t>::max()) + 1;
+  try {
+    c3d::bvh::dual_spheres(too_many, nullptr);
+    std::printf("bvh accepted %zu primitives\n", too_many);
+    return 1;
+  } catch (const std::length_error &) {
+  }
+
+  std::printf("ok (%s kernels)\n", c3d::kernels::get().isa);
+  return 0;
+}
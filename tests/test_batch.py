@@ -0,0 +1,316 @@
+import sys
+sys.path.append('build')
+
+import os
+import subprocess
+
+import numpy as np
+import numpy.random as rnd
+
+from pyversor.c3d import (Bivector, Trivector, Vector, batch, construct, fit,
+                          generate, spatial)
+from pyversor.c3d.versors import Motor
+
+
+def dual_spheres(centers, radii):
+    s = batch.null(centers)
+    s[..., 4] -= 0.5 * radii ** 2
+    return s
+
+
+def kernel_results():
+    rnd.seed(0)
+    dll = rnd.randn(100, 6)
+    motors = batch.exp(dll)
+    points = batch.null(rnd.randn(100, 3))
+    d = rnd.randn(300, 3)
+    d /= np.linalg.norm(d, axis=1)[:, None]
+    x = np.concatenate([d, rnd.uniform(-3, 3, (200, 3))])
+    spheres = dual_spheres(rnd.uniform(-5, 5, (300, 3)),
+                           rnd.uniform(0.1, 0.5, 300))
+    targets = np.concatenate([spheres[:20], [[0.6, 0.0, 0.8, 0.0, 0.5]]])
+    lines = rnd.randn(5, 6)
+    queries = rnd.uniform(-5, 5, (500, 3))
+    return [
+        motors,
+        batch.log(motors),
+        batch.geometric(motors, motors[::-1]),
+        batch.spin(points, motors),
+        fit.ransac(x, 'sphere', 0.01)[1],
+        spatial.collisions(spheres)[0],
+        spatial.collisions(spheres)[1],
+    ] + [
+        r for kind in ('distance', 'inner')
+        for r in spatial.distance_field(queries, targets, lines, True, kind)
+    ]
+
+
+def test_kernels_match_baseline():
+    isa = batch.isa()
+    try:
+        batch.select_isa('baseline')
+        expected = kernel_results()
+        for other in batch.available_isas():
+            batch.select_isa(other)
+            for a, b in zip(kernel_results(), expected):
+                assert a.shape == b.shape
+                if a.dtype == np.float64:
+                    assert np.allclose(a, b, rtol=1e-9, atol=1e-9)
+                else:
+                    assert (a == b).all()
+    finally:
+        batch.select_isa(isa)
+
+
+def test_unavailable_isa():
+    try:
+        batch.select_isa('sse1')
+    except ValueError:
+        pass
+    else:
+        assert False
+    # An unsupported override falls back to the fastest instruction set.
+    env = dict(os.environ, PYVERSOR_ISA='sse1')
+    code = ("import sys; sys.path.append('build'); "
+            "from pyversor.c3d import batch; print(batch.isa())")
+    out = subprocess.check_output([sys.executable, '-c', code], env=env)
+    assert out.decode().strip() == batch.available_isas()[-1]
+
+
+def test_hspin_follows_geodesic():
+    rnd.seed(1)
+    x = rnd.uniform(-0.5, 0.5, (200, 3))
+    y = rnd.uniform(-0.5, 0.5, (200, 3))
+    a = batch.null(x)
+    b = batch.null(y)
+    d = batch.hdist(a, b)
+    gap = np.sum((x - y) ** 2, axis=1)
+    scale = (1 - np.sum(x * x, axis=1)) * (1 - np.sum(y * y, axis=1))
+    assert np.allclose(d, np.arccosh(1 + 2 * gap / scale), atol=1e-12)
+    assert np.allclose(batch.normalize(batch.hspin(a, b, np.ones(1)))[:, :3],
+                       y, atol=1e-12)
+    for t in (0.25, 0.5):
+        p = batch.hspin(a, b, np.full(1, t))
+        assert np.allclose(batch.hdist(a, p), t * d, atol=1e-12)
+        assert np.allclose(batch.hdist(p, b), (1 - t) * d, atol=1e-12)
+
+
+def same_versors(a, b, atol=1e-12):
+    # V and -V are the same transformation.
+    return np.allclose(np.minimum(np.abs(a - b), np.abs(a + b)).max(axis=-1),
+                       0, atol=atol)
+
+
+def rotators(n):
+    # Random unit rotators, followed by half turns about the axes and about
+    # another axis, which take every branch of Shepperd's method.
+    r = rnd.randn(n, 4)
+    r /= np.linalg.norm(r, axis=1)[:, None]
+    half_turns = [[0, 1, 0, 0], [0, 0, 1, 0], [0, 0, 0, 1], [0, 0.6, 0, 0.8],
+                  [1, 0, 0, 0]]
+    return np.concatenate([r, half_turns])
+
+
+def test_matrix_round_trips():
+    rnd.seed(2)
+    rot = rotators(100)
+    n = len(rot)
+    translations = np.zeros((n, 6))
+    translations[:, 3:] = rnd.randn(n, 3)
+    motors = batch.geometric(np.pad(rot, ((0, 0), (0, 4))),
+                             batch.exp(translations))
+    x = batch.motor_to_matrix(motors)
+    assert x.shape == (n, 4, 4)
+    assert same_versors(batch.matrix_to_motor(x), motors)
+    p = rnd.randn(n, 3)
+    moved = batch.normalize(batch.spin(batch.null(p), motors))[:, :3]
+    assert np.allclose(np.einsum('nij,nj->ni', x[:, :3, :3], p) + x[:, :3, 3],
+                       moved, atol=1e-12)
+    m = batch.rotator_to_matrix(rot)
+    assert np.allclose(np.einsum('nij,nkj->nik', m, m), np.eye(3), atol=1e-12)
+    assert same_versors(batch.matrix_to_rotator(m), rot)
+
+
+def test_quaternion_round_trips():
+    rnd.seed(3)
+    rot = rotators(100)
+    q = batch.rotator_to_quaternion(rot)
+    assert np.allclose(q, rot[:, [0, 3, 2, 1]] * [1, -1, 1, -1])
+    assert np.allclose(batch.quaternion_to_rotator(q), rot)
+    w, x, y, z = q.T
+    expected = np.stack([
+        1 - 2 * (y * y + z * z), 2 * (x * y - w * z), 2 * (x * z + w * y),
+        2 * (x * y + w * z), 1 - 2 * (x * x + z * z), 2 * (y * z - w * x),
+        2 * (x * z - w * y), 2 * (y * z + w * x), 1 - 2 * (x * x + y * y)
+    ], axis=1).reshape(-1, 3, 3)
+    assert np.allclose(batch.rotator_to_matrix(rot), expected, atol=1e-12)
+
+
+def test_euler_round_trips():
+    rnd.seed(4)
+    n = 1000
+    angles = np.stack([rnd.uniform(-np.pi, np.pi, n),
+                       rnd.uniform(-np.pi / 2, np.pi / 2, n),
+                       rnd.uniform(-np.pi, np.pi, n)], axis=1)
+    rot = batch.euler_to_rotator(angles)
+    assert np.allclose(np.linalg.norm(rot, axis=1), 1)
+    assert np.allclose(batch.rotator_to_euler(rot), angles, atol=1e-9)
+    # Rotators of any norm give the same angles.
+    assert np.allclose(batch.rotator_to_euler(3.5 * rot), angles, atol=1e-9)
+    spherical = angles[:, [0, 2]]
+    assert np.allclose(batch.spherical_to_rotator(spherical),
+                       batch.euler_to_rotator(angles * [1, 0, 1]))
+
+
+def test_euler_gimbal_lock():
+    rnd.seed(5)
+    angles = rnd.uniform(-np.pi, np.pi, (100, 3))
+    angles[:50, 1] = np.pi / 2
+    angles[50:, 1] = -np.pi / 2
+    rot = batch.euler_to_rotator(angles)
+    found = batch.rotator_to_euler(rot)
+    # Yaw and roll turn about the same axis, so roll is taken as zero and the
+    # rotation is kept.
+    assert (found[:, 2] == 0).all()
+    assert np.allclose(found[:, 1], angles[:, 1])
+    assert same_versors(batch.euler_to_rotator(found), rot)
+
+
+def test_normalize_motors():
+    rnd.seed(6)
+    motors = batch.exp(rnd.randn(200, 6))
+    reverse = np.array([1, -1, -1, -1, -1, -1, -1, 1])
+    unit = np.zeros(8)
+    unit[0] = 1
+    # Drift in scale alone leaves the pose as it was.
+    assert np.allclose(batch.normalize_motors(1.3 * motors), motors,
+                       atol=1e-12)
+    drifted = 1.3 * motors + 1e-3 * rnd.randn(200, 8)
+    found = batch.normalize_motors(drifted)
+    assert np.allclose(batch.geometric(found, found * reverse), unit,
+                       atol=1e-12)
+    assert np.abs(found - motors).max() < 1e-2
+    for m, f in zip(drifted[:10], found):
+        assert np.allclose(np.array(Motor(*m).normalize()), f, atol=1e-12)
+
+
+def test_boosts_match_generate():
+    rnd.seed(7)
+    pairs = 0.5 * rnd.randn(50, 10)
+    x = batch.null(rnd.randn(50, 3))
+    boosts = [generate.boost(Bivector(*p)) for p in pairs]
+    assert np.allclose(batch.boost(pairs), [np.array(b) for b in boosts],
+                       atol=1e-12)
+    expected = [np.array(Vector(*v).spin(b)) for v, b in zip(x, boosts)]
+    assert np.allclose(batch.boost_spin(x, pairs), expected, atol=1e-12)
+    # A single point or pair is broadcast over the other.
+    expected = [np.array(Vector(*x[0]).spin(b)) for b in boosts]
+    assert np.allclose(batch.boost_spin(x[0], pairs), expected, atol=1e-12)
+    expected = [np.array(Vector(*v).spin(boosts[0])) for v in x]
+    assert np.allclose(batch.boost_spin(x, pairs[0]), expected, atol=1e-12)
+
+
+def test_dilators_match_generate():
+    rnd.seed(8)
+    centers = batch.null(rnd.randn(50, 3))
+    x = batch.null(rnd.randn(50, 3))
+    t = rnd.randn(50)
+
+    def dilators(c, t):
+        return [generate.dilator(Vector(*ci), ti) for ci, ti in zip(c, t)]
+
+    def spun(x, d):
+        return [np.array(Vector(*xi).spin(di)) for xi, di in zip(x, d)]
+
+    d = dilators(centers, t)
+    assert np.allclose(batch.dilator(centers, t), [np.array(v) for v in d],
+                       atol=1e-12)
+    assert np.allclose(batch.dilate(x, centers, t), spun(x, d), atol=1e-12)
+    # t is broadcast as a scalar, or over a single point and center.
+    d = dilators(centers, np.full(50, 0.7))
+    assert np.allclose(batch.dilator(centers, 0.7), [np.array(v) for v in d],
+                       atol=1e-12)
+    assert np.allclose(batch.dilate(x, centers, 0.7), spun(x, d), atol=1e-12)
+    d = dilators([centers[0]] * 50, t)
+    assert batch.dilator(centers[0], t).shape == (50, 5)
+    assert np.allclose(batch.dilator(centers[0], t),
+                       [np.array(v) for v in d], atol=1e-12)
+    assert np.allclose(batch.dilate(x[0], centers[0], t), spun([x[0]] * 50, d),
+                       atol=1e-12)
+
+
+def wedge3(a, b, c):
+    # Coefficients of a ^ b ^ c, ordered as those of a circle.
+    blades = [(0, 1, 2), (0, 1, 3), (0, 2, 3), (1, 2, 3), (0, 1, 4),
+              (0, 2, 4), (1, 2, 4), (0, 3, 4), (1, 3, 4), (2, 3, 4)]
+    x = np.stack([a, b, c], axis=-2)
+    return np.stack([np.linalg.det(x[..., list(k)]) for k in blades], axis=-1)
+
+
+def test_circle_points():
+    rnd.seed(9)
+    p = rnd.randn(3, 20, 3)
+    circles = wedge3(*batch.null(p))
+    num = 16
+    t = 2 * np.pi * np.arange(num + 1) / num
+    points = batch.circle_points(circles, t)
+    assert points.shape == (20, num + 1, 5)
+    # The circles are the circumcircles of the triangles p.
+    a, b = p[1] - p[0], p[2] - p[0]
+    n = np.cross(a, b)
+    center = p[0] + (np.cross(np.sum(a * a, axis=1)[:, None] * b -
+                              np.sum(b * b, axis=1)[:, None] * a, n) /
+                     (2 * np.sum(n * n, axis=1))[:, None])
+    radius = np.linalg.norm(p[0] - center, axis=1)
+    x = batch.normalize(points)[..., :3]
+    assert np.allclose(np.linalg.norm(x - center[:, None], axis=2),
+                       radius[:, None])
+    assert np.allclose(np.einsum('nmc,nc->nm', x - center[:, None], n), 0)
+    for i in range(20):
+        c = Trivector(*circles[i])
+        expected = construct.points_on_circle(c, num)
+        assert np.allclose(points[i], [np.array(v) for v in expected],
+                           atol=1e-12)
+        for k in (0, 5):
+            expected = construct.point(c, t[k])
+            assert np.allclose(x[i, k], batch.normalize(np.array(expected))[:3],
+                               atol=1e-12)
+
+
+def test_sphere_points():
+    rnd.seed(10)
+    centers = rnd.randn(20, 3)
+    radii = rnd.uniform(0.5, 2, 20)
+    spheres = dual_spheres(centers, radii)
+    u, v = 7, 5
+    # The angles of points_on_sphere, which takes them in single precision.
+    theta = np.float32(2 * np.pi * np.arange(u) / u).astype(float)
+    phi = np.float32(-np.pi / 2 + np.pi * np.arange(v) / v).astype(float)
+    points = batch.sphere_points(spheres, theta, phi)
+    assert points.shape == (20, u, v, 5)
+    x = batch.normalize(points)[..., :3]
+    d = (x - centers[:, None, None]) / radii[:, None, None, None]
+    ct, st = np.cos(theta)[:, None], np.sin(theta)[:, None]
+    cp, sp = np.cos(phi)[None], np.sin(phi)[None]
+    direction = np.stack(np.broadcast_arrays(cp * ct, -sp, -cp * st), axis=-1)
+    assert np.allclose(d, direction)
+    for i in range(20):
+        expected = construct.points_on_sphere(Vector(*spheres[i]), u, v)
+        assert np.allclose(points[i].reshape(-1, 5),
+                           [np.array(p) for p in expected], atol=1e-6)
+
+
+if __name__ == '__main__':
+    test_kernels_match_baseline()
+    test_unavailable_isa()
+    test_hspin_follows_geodesic()
+    test_matrix_round_trips()
+    test_quaternion_round_trips()
+    test_euler_round_trips()
+    test_euler_gimbal_lock()
+    test_normalize_motors()
+    test_boosts_match_generate()
+    test_dilators_match_generate()
+    test_circle_points()
+    test_sphere_points()
+    print('ok')
@@ -0,0 +1,79 @@
+import sys
+sys.path.append('build')
+
+import numpy as np
+import numpy.random as rnd
+
+from pyversor.c3d import batch, fit
+
+
+def with_outliers(inliers, n):
+    outliers = rnd.uniform(-2, 2, (n, 3))
+    return np.concatenate([inliers, outliers])
+
+
+def test_ransac_sphere():
+    rnd.seed(0)
+    center = np.array([0.3, -0.2, 0.5])
+    radius = 0.8
+    d = rnd.randn(300, 3)
+    d /= np.linalg.norm(d, axis=1)[:, None]
+    x = with_outliers(center + radius * d + 1e-3 * rnd.randn(300, 3), 200)
+    s, mask, _ = fit.ransac(x, 'sphere', 0.01)
+    c = s[:3] / s[3]
+    r = np.sqrt(c.dot(c) - 2 * s[4] / s[3])
+    assert np.linalg.norm(c - center) < 1e-2
+    assert abs(r - radius) < 1e-2
+    assert mask[:300].all()
+    assert mask[300:].mean() < 0.1
+
+
+def test_ransac_plane():
+    rnd.seed(1)
+    normal = np.array([1.0, 2.0, -2.0]) / 3.0
+    u = np.cross(normal, [1.0, 0.0, 0.0])
+    u /= np.linalg.norm(u)
+    v = np.cross(normal, u)
+    st = rnd.uniform(-1, 1, (300, 2))
+    on = 0.4 * normal + st[:, :1] * u + st[:, 1:] * v
+    x = with_outliers(on + 1e-3 * rnd.randn(300, 3), 200)
+    p, mask, _ = fit.ransac(x, 'plane', 0.01)
+    assert abs(abs(p[:3].dot(normal)) - 1) < 1e-4
+    assert np.abs(fit.residuals(on, p)).max() < 2e-2
+    assert mask[:300].all()
+    assert mask[300:].mean() < 0.1
+
+
+def test_ransac_stops_early():
+    rnd.seed(3)
+    for n in (100, 600):
+        d = rnd.randn(n // 2, 3)
+        d /= np.linalg.norm(d, axis=1)[:, None]
+        x = with_outliers(d, n - n // 2)
+        s, mask, iterations = fit.ransac(x, 'sphere', 0.01)
+        # About 70 draws reach 0.99 confidence at half inliers.
+        assert mask[:n // 2].all()
+        assert iterations < 1000
+
+
+def test_registration_recovers_motor():
+    rnd.seed(2)
+    motors = batch.exp(rnd.randn(20, 6))
+    a = rnd.randn(20, 50, 3)
+    b = np.empty_like(a)
+    for i in range(20):
+        p = batch.spin(batch.null(a[i]), motors[i])
+        b[i] = batch.normalize(p)[:, :3]
+    found = fit.motors(a, b)
+    # A motor and its negative are the same rigid motion.
+    error = np.minimum(np.abs(found - motors).max(axis=1),
+                       np.abs(found + motors).max(axis=1))
+    assert error.max() < 1e-9
+
+
+if __name__ == '__main__':
+    test_ransac_sphere()
+    test_ransac_plane()
+    test_ransac_stops_early()
+    test_registration_recovers_motor()
+    print('ok')
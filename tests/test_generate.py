@@ -0,0 +1,73 @@
+import sys
+sys.path.append('build')
+
+import numpy as np
+import numpy.random as rnd
+
+from pyversor.c3d import batch, generate
+
+# Coefficient of e_i ^ e_j in a pair, over the basis (e1, e2, e3, no, ni).
+PAIR = {(0, 1): 0, (0, 2): 1, (1, 2): 2, (0, 3): 3, (1, 3): 4, (2, 3): 5,
+        (0, 4): 6, (1, 4): 7, (2, 4): 8, (3, 4): 9}
+
+
+def wedge(a, b):
+    p = np.zeros(a.shape[:-1] + (10,))
+    for (i, j), k in PAIR.items():
+        p[..., k] = a[..., i] * b[..., j] - a[..., j] * b[..., i]
+    return p
+
+
+def test_split_pairs():
+    rnd.seed(0)
+    pairs = rnd.randn(100, 10)
+    split, count = generate.split_pairs(pairs)
+    assert (count == 2).all()
+    assert np.allclose(split.sum(axis=1), pairs, atol=1e-9)
+
+
+def test_split_retries():
+    rnd.seed(1)
+    # Small bivectors are degenerate to the split, so they are perturbed a
+    # bounded number of times; those that square to about zero stay whole.
+    pairs = 0.01 * rnd.randn(100, 10)
+    split, count = generate.split_pairs(pairs)
+    assert ((count == 1) | (count == 2)).all()
+    assert np.isfinite(split).all()
+    assert np.abs(split.sum(axis=1) - pairs).max() < 0.1
+
+
+def test_split_nilpotent():
+    rnd.seed(2)
+    # Pairs e ^ ni square to zero and have only themselves as split and log.
+    pairs = np.zeros((20, 10))
+    pairs[:, 6:9] = rnd.randn(20, 3)
+    split, count = generate.split_pairs(pairs)
+    assert (count == 1).all()
+    assert np.allclose(split[:, 0], pairs)
+    assert (split[:, 1] == 0).all()
+    rotors = np.zeros((20, 16))
+    rotors[:, 0] = 1
+    rotors[:, 1:11] = pairs
+    logs, count = generate.split_logs(rotors)
+    assert (count == 1).all()
+    assert np.allclose(logs[:, 0], pairs)
+    assert (logs[:, 1] == 0).all()
+
+
+def test_split_points():
+    rnd.seed(3)
+    a = rnd.randn(50, 3)
+    b = rnd.randn(50, 3)
+    points, real = batch.split(wedge(batch.null(a), batch.null(b)))
+    assert real.all()
+    assert np.allclose(points[:, 0, :3], b)
+    assert np.allclose(points[:, 1, :3], a)
+
+
+if __name__ == '__main__':
+    test_split_pairs()
+    test_split_retries()
+    test_split_nilpotent()
+    test_split_points()
+    print('ok')
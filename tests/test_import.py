@@ -0,0 +1,42 @@
+import sys
+sys.path.append('build')
+
+import subprocess
+
+
+def run(code):
+    # Each check needs a fresh interpreter, since submodules stay loaded.
+    code = "import sys; sys.path.append('build')\n" + code
+    subprocess.check_call([sys.executable, '-c', code])
+
+
+def test_e3d_does_not_load_c3d():
+    run("import __pyversor__\n"
+        "import pyversor.e3d\n"
+        "assert 'pyversor.c3d' not in sys.modules\n"
+        "assert 'Vector' in vars(__pyversor__.e3d)\n"
+        "assert 'Vector' not in vars(__pyversor__.c3d)\n")
+
+
+def test_star_import():
+    run("import numpy as np\n"
+        "from pyversor.c3d import *\n"
+        "assert (np.array(Vector(1, 2, 3, 4, 5)) == [1, 2, 3, 4, 5]).all()\n"
+        "assert batch.null is not None\n")
+
+
+def test_dunder_lookups_do_not_load():
+    run("import __pyversor__\n"
+        "c3d = __pyversor__.c3d\n"
+        "for name in ('__path__', '__all__', '__wrapped__', '__spec__x__'):\n"
+        "    assert not hasattr(c3d, name)\n"
+        "assert 'Vector' not in vars(c3d)\n"
+        "assert c3d.Vector is not None\n"
+        "assert 'Vector' in vars(c3d)\n")
+
+
+if __name__ == '__main__':
+    test_e3d_does_not_load_c3d()
+    test_star_import()
+    test_dunder_lookups_do_not_load()
+    print('ok')
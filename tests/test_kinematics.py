@@ -0,0 +1,113 @@
+import sys
+sys.path.append('build')
+
+import numpy as np
+import numpy.random as rnd
+
+from pyversor.c3d import batch, kinematics
+
+
+def keyframes(n, angle):
+    # Motors whose rotations between neighbours are about `angle`.
+    dll = np.zeros((n, 6))
+    dll[:, :3] = angle * np.cumsum(rnd.randn(n, 3), axis=0)
+    dll[:, 3:] = rnd.randn(n, 3)
+    return batch.exp(dll), np.arange(n, dtype=float)
+
+
+def test_spline_knot_continuity():
+    rnd.seed(0)
+    eps = 1e-9
+    for angle in (1.0, 1e-3, 1e-6):
+        motors, times = keyframes(6, angle)
+        knots = times[1:-1]
+        t = np.concatenate([knots - eps, knots + eps])
+        for kind in ('linear', 'bspline'):
+            spline = kinematics.Spline(motors, times, kind)
+            m, v, a = spline.evaluate(t, derivatives=True)
+            before, after = np.split(m, 2)
+            assert np.abs(before - after).max() < 1e-7
+            if kind == 'bspline':
+                before, after = np.split(v, 2)
+                assert np.abs(before - after).max() < 1e-7
+                before, after = np.split(a, 2)
+                assert np.abs(before - after).max() < 1e-7
+
+
+def test_forward_small_angles():
+    rnd.seed(3)
+    axes = 0.5 * rnd.randn(6, 6)
+    chain = kinematics.Chain(axes, dual=True)
+    theta = 1e-6 * rnd.randn(100, 6)
+    end = chain.forward(theta)
+    # Gen::mot(theta L) = 1 + theta L to first order, rotation included.
+    assert np.abs(end[:, 0] - 1.0).max() < 1e-9
+    assert np.abs(end[:, 1:7] - theta.dot(axes)).max() < 1e-9
+
+
+def test_chain_without_joints():
+    try:
+        kinematics.Chain(np.zeros((0, 6)), dual=True)
+    except ValueError:
+        pass
+    else:
+        assert False
+
+
+def test_inverse_negated_targets():
+    rnd.seed(1)
+    chain = kinematics.Chain(0.5 * rnd.randn(6, 6), dual=True)
+    start = rnd.randn(200, 6)
+    targets = chain.forward(start + 0.03 * rnd.randn(200, 6))
+    theta, residual = chain.inverse(targets, start)
+    assert np.mean(residual < 1e-9) > 0.9
+    # -M is the same pose as M, so it must be solved the same way.
+    negated, negated_residual = chain.inverse(-targets, start)
+    assert np.allclose(negated, theta, atol=1e-12)
+    assert np.allclose(negated_residual, residual, atol=1e-12)
+
+
+def test_inverse_small_angles():
+    rnd.seed(2)
+    chain = kinematics.Chain(0.5 * rnd.randn(6, 6), dual=True)
+    expected = 1e-6 * rnd.randn(100, 6)
+    targets = chain.forward(expected)
+    theta, residual = chain.inverse(targets)
+    assert residual.max() < 1e-9
+    assert np.abs(theta - expected).max() < 1e-8
+
+
+def invariants(motors, twists, inertia):
+    # Kinetic energy, angular momentum and speed of each body from its twist
+    # in its own frame, ~M V M.
+    reverse = motors * np.array([1, -1, -1, -1, -1, -1, -1, 1])
+    v = np.zeros(motors.shape)
+    v[:, 1:7] = twists
+    b = batch.geometric(batch.geometric(reverse, v), motors)
+    w = np.stack([-2 * b[:, 3], 2 * b[:, 2], -2 * b[:, 1]], axis=1)
+    u = -2 * b[:, 4:7]
+    energy = 0.5 * np.sum(inertia * w * w, axis=1)
+    momentum = np.linalg.norm(inertia * w, axis=1)
+    return np.stack([energy, momentum, np.linalg.norm(u, axis=1)], axis=1)
+
+
+def test_rigid_body_conservation():
+    rnd.seed(4)
+    motors = batch.exp(rnd.randn(10, 6))
+    twists = 0.5 * rnd.randn(10, 6)
+    inertia = rnd.uniform(1, 3, (10, 3))
+    bodies = kinematics.RigidBodies(motors, twists, inertia)
+    before = invariants(motors, twists, inertia)
+    bodies.step(0.01, 1000, 'rk4')
+    after = invariants(bodies.motors, bodies.twists, inertia)
+    assert np.abs(after / before - 1).max() < 1e-6
+
+
+if __name__ == '__main__':
+    test_spline_knot_continuity()
+    test_forward_small_angles()
+    test_chain_without_joints()
+    test_inverse_negated_targets()
+    test_inverse_small_angles()
+    test_rigid_body_conservation()
+    print('ok')
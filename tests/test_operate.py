@@ -0,0 +1,43 @@
+import sys
+sys.path.append('build')
+
+import numpy as np
+import numpy.random as rnd
+
+from pyversor.c3d import Vector, generate, operate
+from pyversor.c3d.flats import DualLine, Line
+
+
+def random_motor():
+    return generate.exp(DualLine(*rnd.randn(6)))
+
+
+def test_outermorphism_matches_spin():
+    rnd.seed(0)
+    for _ in range(10):
+        m = random_motor()
+        o = operate.compile_outermorphism(m)
+        for t, n in ((Vector, 5), (DualLine, 6), (Line, 6)):
+            x = t(*rnd.randn(n))
+            assert np.allclose(np.array(o.apply(x)), np.array(x.spin(m)),
+                               atol=1e-12)
+        x = rnd.randn(100, 5)
+        expected = [np.array(Vector(*v).spin(m)) for v in x]
+        assert np.allclose(o.apply(x, 'vector'), expected, atol=1e-12)
+
+
+def test_outermorphism_rejects_non_versors():
+    rnd.seed(1)
+    m = random_motor() + random_motor()
+    try:
+        operate.compile_outermorphism(m)
+    except ValueError:
+        pass
+    else:
+        assert False
+
+
+if __name__ == '__main__':
+    test_outermorphism_matches_spin()
+    test_outermorphism_rejects_non_versors()
+    print('ok')
@@ -0,0 +1,85 @@
+import sys
+sys.path.append('build')
+
+import numpy as np
+import numpy.random as rnd
+
+from pyversor.c3d import Vector, generate
+from pyversor.c3d.flats import DualLine
+from pyversor.c3d.versors import Motor
+
+
+def random_motor():
+    return generate.exp(DualLine(*rnd.randn(6)))
+
+
+def test_inplace_keeps_identity():
+    rnd.seed(0)
+    a = random_motor()
+    b = random_motor()
+    expected = np.array(a) + np.array(b)
+    a0 = a
+    a += b
+    assert a is a0
+    assert np.allclose(np.array(a), expected)
+    d = DualLine(*rnd.randn(6))
+    expected = np.array(a) + np.concatenate([[0], np.array(d), [0]])
+    a += d
+    assert a is a0
+    assert np.allclose(np.array(a), expected)
+    expected = np.array(a) - np.array(b)
+    a -= b
+    assert a is a0
+    assert np.allclose(np.array(a), expected)
+    a *= 2.0
+    assert a is a0
+    assert np.allclose(np.array(a), 2 * expected)
+
+
+def test_inplace_product_only_within_type():
+    rnd.seed(1)
+    # A motor times a motor is a motor, so it is updated in place.
+    a = random_motor()
+    b = random_motor()
+    expected = np.array(a * b)
+    a0 = a
+    a *= b
+    assert a is a0
+    assert np.allclose(np.array(a), expected)
+    # Two vectors multiply to a rotor, so `*=` rebinds to the product and
+    # leaves the vector alone.
+    v = Vector(*rnd.randn(5))
+    w = Vector(*rnd.randn(5))
+    before = np.array(v)
+    v0 = v
+    v *= w
+    assert v is not v0
+    assert (np.array(v0) == before).all()
+    assert np.allclose(np.array(v), np.array(v0 * w))
+
+
+def test_out_arguments():
+    rnd.seed(2)
+    a = random_motor()
+    b = random_motor()
+    out = Motor()
+    assert a.geometric(b, out=out) is out
+    assert np.allclose(np.array(out), np.array(a * b))
+    # The output may alias an input.
+    expected = np.array(a * b)
+    assert a.geometric(b, out=a) is a
+    assert np.allclose(np.array(a), expected)
+    expected = np.array(b * b)
+    assert b.geometric(b, out=b) is b
+    assert np.allclose(np.array(b), expected)
+    v = Vector(*rnd.randn(5))
+    expected = np.array(v.spin(a))
+    assert v.spin(a, out=v) is v
+    assert np.allclose(np.array(v), expected)
+
+
+if __name__ == '__main__':
+    test_inplace_keeps_identity()
+    test_inplace_product_only_within_type()
+    test_out_arguments()
+    print('ok')
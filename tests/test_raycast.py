@@ -0,0 +1,67 @@
+import sys
+sys.path.append('build')
+
+import numpy as np
+import numpy.random as rnd
+
+from pyversor.c3d import Vector, batch, construct
+from pyversor.c3d.flats import DualLine
+
+# The unit sphere at the origin and the planes x = 2 and z = 0.5.
+TARGETS = np.array([[0.0, 0.0, 0.0, 1.0, -0.5],
+                    [1.0, 0.0, 0.0, 0.0, 2.0],
+                    [0.0, 0.0, 1.0, 0.0, 0.5]])
+
+
+def x_lines(y):
+    # Dual lines along x through (0, y, 0).
+    dll = np.zeros((len(y), 6))
+    dll[:, 2] = 1.0
+    dll[:, 5] = -np.asarray(y)
+    return dll
+
+
+def test_meet_matches_construct():
+    rnd.seed(0)
+    dll = rnd.randn(20, 6)
+    spheres = batch.null(rnd.randn(10, 3))
+    spheres[:, 4] -= 0.5 * rnd.uniform(0.5, 2.0, 10) ** 2
+    planes = rnd.randn(10, 5)
+    planes[:, 3] = 0.0
+    targets = np.concatenate([spheres, planes, TARGETS])
+    found = batch.meet(dll, targets, dual=True)
+    assert found.shape == (20, 23, 10)
+    for i in range(20):
+        for j in range(23):
+            expected = construct.meet(DualLine(*dll[i]), Vector(*targets[j]))
+            assert np.allclose(found[i, j], np.array(expected), atol=1e-12)
+
+
+def test_split_hits_misses_and_tangents():
+    # Through the center, tangent to and past the unit sphere.
+    pairs = batch.meet(x_lines([0.0, 1.0, 2.0]), TARGETS, dual=True)
+    points, real = batch.split(pairs)
+    assert (real == [[True, True, False],
+                     [True, True, False],
+                     [False, True, False]]).all()
+    assert np.allclose(points[0, 0, :3], [[1, 0, 0], [-1, 0, 0]])
+    assert np.allclose(points[1, 0, :3], [[0, 1, 0], [0, 1, 0]])
+    assert np.allclose(points[2, 0, :3], [[0, 2, 0], [0, 2, 0]])
+    for y in range(3):
+        assert np.allclose(points[y, 1, :3], [[2, y, 0], [2, y, 0]])
+
+
+def test_nearest():
+    dll = x_lines([0.0, 1.0, 2.0, 0.5])
+    origins = np.array([[-5, 0, 0], [-5, 1, 0], [-5, 2, 0], [5, 0.5, 0]])
+    index, distance = batch.nearest(dll, TARGETS, origins, dual=True)
+    assert (index == [0, 0, 1, -1]).all()
+    assert np.allclose(distance[:3], [4, 5, 7])
+    assert distance[3] == np.inf
+
+
+if __name__ == '__main__':
+    test_meet_matches_construct()
+    test_split_hits_misses_and_tangents()
+    test_nearest()
+    print('ok')
@@ -0,0 +1,224 @@
+import sys
+sys.path.append('build')
+
+import numpy as np
+import numpy.random as rnd
+
+from pyversor.c3d import batch, spatial
+
+
+def dual_spheres(centers, radii):
+    s = batch.null(centers)
+    s[..., 4] -= 0.5 * radii ** 2
+    return s
+
+
+def dual_lines(origins, directions):
+    # Dual lines through the origins along the directions.
+    d = directions
+    dll = np.empty(origins.shape[:-1] + (6,))
+    dll[..., 0] = d[..., 2]
+    dll[..., 1] = -d[..., 1]
+    dll[..., 2] = d[..., 0]
+    dll[..., 3:] = np.cross(origins, d)
+    return dll
+
+
+def first_hits(origins, directions, centers, radii):
+    # First sphere hit by each ray and the distance to it, by brute force.
+    d = directions / np.linalg.norm(directions, axis=-1)[..., None]
+    oc = origins[:, None, :] - centers[None, :, :]
+    b = np.sum(oc * d[:, None, :], axis=-1)
+    c = np.sum(oc * oc, axis=-1) - radii ** 2
+    disc = b * b - c
+    root = np.sqrt(np.maximum(disc, 0.0))
+    near = -b - root
+    t = np.where(near >= 0.0, near, -b + root)
+    t = np.where((disc >= 0.0) & (t >= 0.0), t, np.inf)
+    index = np.argmin(t, axis=1)
+    distance = t[np.arange(len(t)), index]
+    return np.where(np.isinf(distance), -1, index), distance
+
+
+def random_spheres(n):
+    return rnd.uniform(-10, 10, (n, 3)), rnd.uniform(0.2, 1.5, n)
+
+
+def test_bvh_raycast():
+    rnd.seed(0)
+    centers, radii = random_spheres(500)
+    tree = spatial.BVH.from_dual_spheres(dual_spheres(centers, radii))
+    assert len(tree) == 500
+    origins = rnd.uniform(-12, 12, (1000, 3))
+    directions = rnd.randn(1000, 3)
+    index, distance = tree.raycast(dual_lines(origins, directions), origins,
+                                   dual=True)
+    expected_index, expected_distance = first_hits(origins, directions,
+                                                   centers, radii)
+    assert (index == expected_index).all()
+    assert np.allclose(distance, expected_distance, atol=1e-9)
+    assert (index >= 0).any() and (index < 0).any()
+
+
+def test_bvh_overlap():
+    rnd.seed(1)
+    centers, radii = random_spheres(500)
+    # Spheres that touch the last primitive from outside, with coefficients
+    # that make the contact exact.
+    centers[-1] = [1.0, 2.0, 3.0]
+    radii[-1] = 1.0
+    tree = spatial.BVH.from_dual_spheres(dual_spheres(centers, radii))
+    queries, sizes = random_spheres(200)
+    queries[-2:] = centers[-1] + 1.5 * np.eye(3)[:2]
+    sizes[-2:] = 0.5
+    offsets, indices = tree.overlap(dual_spheres(queries, sizes))
+    assert len(offsets) == 201
+    gap = np.linalg.norm(queries[:, None] - centers[None], axis=-1)
+    expected = gap <= sizes[:, None] + radii[None]
+    for i in range(200):
+        found = np.sort(indices[offsets[i]:offsets[i + 1]])
+        assert (found == np.flatnonzero(expected[i])).all()
+    assert 499 in indices[offsets[-3]:]
+
+
+def test_bvh_nearest():
+    rnd.seed(2)
+    centers, radii = random_spheres(500)
+    tree = spatial.BVH.from_dual_spheres(dual_spheres(centers, radii))
+    x = rnd.uniform(-12, 12, (1000, 3))
+    index, distance = tree.nearest(x)
+    gap = np.abs(np.linalg.norm(x[:, None] - centers[None], axis=-1) - radii)
+    assert (index == np.argmin(gap, axis=1)).all()
+    assert np.allclose(distance, gap.min(axis=1), atol=1e-9)
+
+
+def test_bvh_empty():
+    tree = spatial.BVH.from_dual_spheres(np.zeros((0, 5)))
+    assert len(tree) == 0
+    origins = np.zeros((3, 3))
+    index, distance = tree.raycast(dual_lines(origins, np.eye(3)), origins,
+                                   dual=True)
+    assert (index == -1).all()
+    assert np.isinf(distance).all()
+
+
+def all_pairs(a, ra, b, rb):
+    gap = np.linalg.norm(a[:, None] - b[None], axis=-1)
+    return np.nonzero(gap <= ra[:, None] + rb[None])
+
+
+def test_collisions():
+    rnd.seed(3)
+    centers, radii = random_spheres(400)
+    # A grid of spheres that touch their neighbours exactly.
+    grid = np.stack(np.meshgrid(*[np.arange(4.0)] * 3), axis=-1)
+    centers = np.concatenate([centers, grid.reshape(-1, 3) + 20.0])
+    radii = np.concatenate([radii, np.full(64, 0.5)])
+    first, second = spatial.collisions(dual_spheres(centers, radii))
+    i, j = all_pairs(centers, radii, centers, radii)
+    upper = i < j
+    assert (first == i[upper]).all()
+    assert (second == j[upper]).all()
+    assert (first >= 400).sum() == 144
+
+
+def test_collisions_between_sets():
+    rnd.seed(4)
+    a, ra = random_spheres(300)
+    b, rb = random_spheres(200)
+    first, second = spatial.collisions(dual_spheres(a, ra),
+                                       dual_spheres(b, rb))
+    i, j = all_pairs(a, ra, b, rb)
+    assert (first == i).all()
+    assert (second == j).all()
+
+
+def test_collisions_of_few_spheres():
+    s = dual_spheres(np.zeros((2, 3)), np.ones(2))
+    for n in (0, 1):
+        first, second = spatial.collisions(s[:n])
+        assert len(first) == 0 and len(second) == 0
+        first, second = spatial.collisions(s[:n], s)
+        assert (first == np.repeat(np.arange(n), 2)).all()
+        assert (second == np.tile(np.arange(2), n)).all()
+
+
+def brute_field(x, targets, lines, kind):
+    # Field of every primitive at every point, targets first.
+    fields = []
+    for t in targets:
+        if t[3] == 0:
+            norm = np.linalg.norm(t[:3])
+            fields.append(t[4] / norm - x.dot(t[:3] / norm))
+            continue
+        c = t[:3] / t[3]
+        r2 = c.dot(c) - 2 * t[4] / t[3]
+        d2 = np.sum((x - c) ** 2, axis=-1)
+        if kind == 'inner':
+            fields.append(0.5 * (d2 - r2))
+        else:
+            fields.append(np.sqrt(d2) - np.sqrt(r2))
+    for l in lines:
+        d = np.array([l[2], -l[1], l[0]])
+        d2 = np.sum((np.cross(x, d) - l[3:]) ** 2, axis=-1) / d.dot(d)
+        fields.append(0.5 * d2 if kind == 'inner' else np.sqrt(d2))
+    fields = np.stack(fields, axis=-1)
+    return fields.min(axis=-1), fields.argmin(axis=-1)
+
+
+def field_primitives():
+    centers, radii = random_spheres(20)
+    planes = rnd.randn(3, 5)
+    planes[:, 3] = 0
+    targets = np.concatenate([dual_spheres(centers, radii), planes])
+    lines = dual_lines(rnd.uniform(-5, 5, (4, 3)), rnd.randn(4, 3))
+    return targets, lines
+
+
+def test_distance_field():
+    rnd.seed(5)
+    targets, lines = field_primitives()
+    # Not a whole number of tiles of points.
+    x = rnd.uniform(-12, 12, (3 * 512 + 7, 3))
+    for kind in ('distance', 'inner'):
+        value, index = spatial.distance_field(x, targets, lines, True, kind)
+        expected_value, expected_index = brute_field(x, targets, lines, kind)
+        assert (index == expected_index).all()
+        assert np.allclose(value, expected_value, atol=1e-9)
+    value, index = spatial.distance_field(x)
+    assert np.isinf(value).all() and (index == -1).all()
+
+
+def test_distance_grid():
+    rnd.seed(6)
+    targets, lines = field_primitives()
+    origin = np.array([-10.0, -8.0, -6.0])
+    spacing = np.array([2.0, 1.5, 1.0])
+    shape = (9, 11, 13)
+    axes = [origin[a] + spacing[a] * np.arange(shape[a]) for a in range(3)]
+    x = np.stack(np.meshgrid(*axes, indexing='ij'), axis=-1)
+    for kind in ('distance', 'inner'):
+        value, index = spatial.distance_grid(origin, spacing, shape, targets,
+                                             lines, True, kind)
+        assert value.shape == shape
+        expected_value, expected_index = brute_field(x, targets, lines, kind)
+        assert (index == expected_index).all()
+        assert np.allclose(value, expected_value, atol=1e-9)
+    value, _ = spatial.distance_grid(origin, 1.5, shape, targets)
+    x = np.stack(np.meshgrid(*[origin[a] + 1.5 * np.arange(shape[a])
+                               for a in range(3)], indexing='ij'), axis=-1)
+    assert np.allclose(value, brute_field(x, targets, [], 'distance')[0],
+                       atol=1e-9)
+
+
+if __name__ == '__main__':
+    test_bvh_raycast()
+    test_bvh_overlap()
+    test_bvh_nearest()
+    test_bvh_empty()
+    test_collisions()
+    test_collisions_between_sets()
+    test_collisions_of_few_spheres()
+    test_distance_field()
+    test_distance_grid()
+    print('ok')